@@ -0,0 +1,16 @@
+// Array iteration functions calling back into JS for each element
+var N = 500;
+var a = [];
+for (var i=0;i<N;i++) a.push(i);
+function bench(name, fn) {
+  var t = getTime();
+  for (var n=0;n<50;n++) fn();
+  return name+" "+((getTime()-t)*20).toFixed(1)+"ms";
+}
+print([
+  bench("forEach", function() { var s=0; a.forEach(function(v,i) { s+=i; }); }),
+  bench("map", function() { a.map(function(v,i) { return v+i; }); }),
+  bench("filter", function() { a.filter(function(v,i) { return i&1; }); }),
+  bench("every", function() { a.every(function(v,i) { return v==i; }); }),
+  bench("reduce", function() { a.reduce(function(p,v,i) { return p+i; }, 0); })
+].join(", "));
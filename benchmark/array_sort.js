@@ -0,0 +1,22 @@
+// Array.sort on different input orders, with and without a compare function
+var N = 500;
+function bench(name, fill, cmp) {
+  var a = [];
+  for (var i=0;i<N;i++) a.push(fill(i));
+  var t = getTime();
+  a.sort(cmp);
+  return name+" "+((getTime()-t)*1000).toFixed(1)+"ms";
+}
+function num(a,b) { return a-b; }
+print("compare fn:", [
+  bench("random", function(i) { return Math.random()*1000; }, num),
+  bench("sorted", function(i) { return i; }, num),
+  bench("reversed", function(i) { return N-i; }, num),
+  bench("duplicates", function(i) { return i%4; }, num)
+].join(", "));
+print("no compare fn:", [
+  bench("random", function(i) { return "x"+Math.round(Math.random()*1000); }),
+  bench("sorted", function(i) { return "x"+(1000+i); }),
+  bench("reversed", function(i) { return "x"+(1000+N-i); }),
+  bench("duplicates", function(i) { return "x"+(i%4); })
+].join(", "));
@@ -0,0 +1,9 @@
+// ++, += and |= on ints, floats and array elements in a loop
+var t = getTime();
+var s = 0.1, n = 0, a = [0,0,0,0,0,0,0,0];
+for (var i=0;i<5000;i++) {
+  s += 0.1;
+  n += i;
+  a[i&7] |= i;
+}
+print(((getTime()-t)*1000).toFixed(1)+"ms");
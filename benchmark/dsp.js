@@ -0,0 +1,32 @@
+// E.sum, E.variance, E.convolve and E.FFT on typed arrays and plain Arrays
+var N = 1024;
+function time(fn) {
+  var t = getTime();
+  for (var n=0;n<20;n++) fn();
+  return ((getTime()-t)*50000).toFixed(0)+"us";
+}
+function bench(name, a) {
+  var b = new a.constructor(a.length);
+  print(name+":", [
+    "sum "+time(function() { E.sum(a); }),
+    "variance "+time(function() { E.variance(a, 1); }),
+    "convolve "+time(function() { E.convolve(a, a, 7); }),
+    "FFT "+time(function() { b.set(a); E.FFT(b); })
+  ].join(", "));
+}
+var i16 = new Int16Array(N), f32 = new Float32Array(N), u8 = new Uint8Array(N);
+for (var i=0;i<N;i++) {
+  f32[i] = Math.sin(i/5)*100;
+  i16[i] = f32[i];
+  u8[i] = f32[i]+128;
+}
+bench("Uint8Array", u8);
+bench("Int16Array", i16);
+bench("Float32Array", f32);
+var arr = [];
+for (i=0;i<256;i++) arr.push(f32[i]);
+print("Array(256):", [
+  "sum "+time(function() { E.sum(arr); }),
+  "variance "+time(function() { E.variance(arr, 1); }),
+  "convolve "+time(function() { E.convolve(arr, arr, 7); })
+].join(", "));
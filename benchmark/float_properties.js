@@ -0,0 +1,13 @@
+// Memory used by objects/arrays holding float values
+var before = process.memory().usage;
+var objs = [];
+for (var i=0;i<50;i++)
+  objs.push({x:i*0.5, y:i*0.25, z:-i*0.125});
+var arr = [];
+for (var i=0;i<200;i++) arr.push(i/8);
+var used = process.memory().usage - before;
+var t = getTime();
+var sum = 0;
+for (var n=0;n<20;n++)
+  for (var i=0;i<objs.length;i++) sum += objs[i].x + objs[i].y + objs[i].z;
+print("vars used: "+used+", sum loop: "+((getTime()-t)*1000).toFixed(1)+"ms");
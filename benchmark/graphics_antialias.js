@@ -0,0 +1,21 @@
+// Anti-aliased primitives vs the aliased ones, at 8 and 16 bpp
+var W = 160, H = 120;
+function bench(name, g, fn) {
+  var t = getTime();
+  for (var n=0;n<20;n++) fn(g, n);
+  return name+" "+((getTime()-t)*1000).toFixed(1)+"ms";
+}
+var curve = [5,110,80,-100,155,110];
+[8,16].forEach(function(bpp) {
+  var g = Graphics.createArrayBuffer(W,H,bpp);
+  g.setColor(-1);
+  print(bpp+"bpp:",[
+    bench("drawLine", g, function(g,n) { for (var i=0;i<20;i++) g.drawLine(0,i*5,W-1,H-1-i*5); }),
+    bench("drawLineAA", g, function(g,n) { for (var i=0;i<20;i++) g.drawLineAA(0,i*5,W-1,H-1-i*5); }),
+    bench("drawCircle", g, function(g,n) { for (var r=5;r<60;r+=5) g.drawCircle(W/2,H/2,r); }),
+    bench("drawCircleAA", g, function(g,n) { for (var r=5;r<60;r+=5) g.drawCircleAA(W/2,H/2,r); }),
+    bench("quadraticBezier+drawPoly", g, function(g,n) { for (var i=0;i<10;i++) g.drawPoly(g.quadraticBezier(curve)); }),
+    bench("drawBezier", g, function(g,n) { for (var i=0;i<10;i++) g.drawBezier(curve); }),
+    bench("drawBezier AA", g, function(g,n) { for (var i=0;i<10;i++) g.drawBezier(curve, true); })
+  ].join(", "));
+});
@@ -0,0 +1,19 @@
+// Compare drawing a 500 point chart with individual calls vs g.draw
+var g = Graphics.createArrayBuffer(120,80,8);
+var pts = [];
+for (var i=0;i<500;i++) pts.push(i*120/500, 40+30*Math.sin(i/20));
+
+var t = getTime();
+for (var n=0;n<10;n++) {
+  g.moveTo(pts[0],pts[1]);
+  for (i=2;i<pts.length;i+=2) g.lineTo(pts[i],pts[i+1]);
+}
+var tCalls = getTime()-t;
+
+var cmds = [["moveTo",pts[0],pts[1]]];
+for (i=2;i<pts.length;i+=2) cmds.push(["lineTo",pts[i],pts[i+1]]);
+t = getTime();
+for (n=0;n<10;n++) g.draw(cmds);
+var tBatch = getTime()-t;
+
+print("Individual calls: "+tCalls.toFixed(3)+"s, g.draw: "+tBatch.toFixed(3)+"s");
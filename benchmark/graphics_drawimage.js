@@ -0,0 +1,15 @@
+// drawImage of a 64x64 image with various source/destination bpp
+var results = [];
+[[1,1],[1,16],[4,16],[8,16],[16,16],[8,8]].forEach(function(b) {
+  var src = b[0], dst = b[1];
+  var g = Graphics.createArrayBuffer(128,96,dst);
+  var img = { width:64, height:64, bpp:src, buffer:new Uint8Array(64*64*src/8).fill(0x5A).buffer };
+  var imgT = { width:64, height:64, bpp:src, buffer:img.buffer, transparent:0 };
+  var t = getTime();
+  for (var i=0;i<50;i++) g.drawImage(img, i, 10);
+  var tOpaque = getTime()-t;
+  t = getTime();
+  for (i=0;i<50;i++) g.drawImage(imgT, i, 10);
+  results.push(src+"->"+dst+"bpp: "+(tOpaque*1000).toFixed(1)+"ms, transparent "+((getTime()-t)*1000).toFixed(1)+"ms");
+});
+print(results.join("\n"));
@@ -0,0 +1,18 @@
+// Graphics fill micro-benchmarks for each bpp: rectangles, horizontal spans, clear and scroll
+var W = 160, H = 120;
+function bench(name, g, fn) {
+  var t = getTime();
+  for (var n=0;n<20;n++) fn(g, n);
+  return name+" "+((getTime()-t)*1000).toFixed(1)+"ms";
+}
+[1,2,4,8,16,24].forEach(function(bpp) {
+  var g = Graphics.createArrayBuffer(W,H,bpp);
+  var col = (1<<bpp)-2;
+  print(bpp+"bpp:",[
+    bench("fillRect", g, function(g,n) { g.setColor(col).fillRect(n,n,W-1-n,H-1-n); }),
+    bench("smallRects", g, function(g,n) { g.setColor(col); for (var i=0;i<100;i++) g.fillRect(i,n,i+7,n+7); }),
+    bench("hlines", g, function(g,n) { g.setColor(col); for (var y=0;y<H;y++) g.drawLine(n,y,W-1-n,y); }),
+    bench("clear", g, function(g,n) { g.setBgColor(n&1).clear(); }),
+    bench("scroll", g, function(g,n) { g.scroll(0,-1); g.scroll(8,0); })
+  ].join(", "));
+});
@@ -0,0 +1,16 @@
+// Redraw the same vector font labels with and without the glyph cache
+var g = Graphics.createArrayBuffer(240,160,8);
+function draw() {
+  for (var i=0;i<50;i++) {
+    g.setFontVector(30).drawString("12:34",10,10);
+    g.setFontVector(14).drawString("Temperature 21.5C",10,60);
+    g.setFontVector(14).drawString("Battery 87%",10,90);
+  }
+}
+var t = getTime();
+draw();
+print("Uncached: "+(getTime()-t).toFixed(3)+"s");
+Graphics.setGlyphCacheSize(4096);
+t = getTime();
+draw();
+print("Cached: "+(getTime()-t).toFixed(3)+"s "+JSON.stringify(Graphics.getGlyphCacheStats()));
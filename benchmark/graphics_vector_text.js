@@ -0,0 +1,19 @@
+// Render vector text and a many-sided polygon - mostly exercises graphicsFillPoly
+var g = Graphics.createArrayBuffer(240,160,8);
+var t = getTime();
+for (var i=0;i<100;i++) {
+  g.clear();
+  g.setFontVector(40).drawString("Hello",0,0);
+  g.setFontVector(20).drawString("The quick brown fox",0,50);
+  g.setFontVector(12).drawString("jumps over the lazy dog 0123456789",0,80);
+}
+print("Vector text: "+(getTime()-t).toFixed(3)+"s");
+
+var star = [];
+for (i=0;i<120;i++) {
+  var r = (i&1) ? 30 : 78, a = i*Math.PI/60;
+  star.push(120+r*Math.sin(a), 80+r*Math.cos(a));
+}
+t = getTime();
+for (i=0;i<100;i++) g.fillPoly(star);
+print("120 point star: "+(getTime()-t).toFixed(3)+"s");
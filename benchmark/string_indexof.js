@@ -0,0 +1,5 @@
+var s = "";
+for (i=0;i<200;i++) s += "0123456789";
+s = E.toString(s+"END");
+var l = 0;
+for (i=0;i<500;i++) l += s.indexOf("END");
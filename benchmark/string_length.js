@@ -0,0 +1,4 @@
+var s = "";
+for (i=0;i<2000;i++) s += "0123456789";
+var l = 0;
+for (i=0;i<2000;i++) l += s.length;
@@ -0,0 +1,4 @@
+var s = "";
+for (i=0;i<2000;i++) s += "0123456789";
+var t = "";
+for (i=0;i<2000;i++) t = s.substr(-10) + s.slice(-5) + s.endsWith("789");
@@ -0,0 +1,23 @@
+// Typed array element reads and writes, from JS and from native code
+var N = 2000;
+function time(fn) {
+  var t = getTime();
+  for (var n=0;n<10;n++) fn();
+  return ((getTime()-t)*100).toFixed(2)+"ms";
+}
+function bench(name, T) {
+  var a = new T(N), b = new T(N), i;
+  print(name+":", [
+    "JS loop "+time(function() {
+      for (i=0;i<N;i++) a[i] = i;
+      for (i=0;i<N;i++) b[i] = a[i];
+    }),
+    "set "+time(function() { b.set(a); }),
+    "copy "+time(function() { new T(a); }),
+    "E.sum "+time(function() { E.sum(a); }),
+    "indexOf "+time(function() { a.indexOf(-1); })
+  ].join(", "));
+}
+bench("Uint8Array", Uint8Array);
+bench("Int16Array", Int16Array);
+bench("Float32Array", Float32Array);
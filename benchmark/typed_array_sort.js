@@ -0,0 +1,19 @@
+// Sorting typed arrays with no compare function
+var N = 5000;
+function bench(name, T, fill) {
+  var a = new T(N);
+  for (var i=0;i<N;i++) a[i] = fill(i);
+  var t = getTime();
+  a.sort();
+  return name+" "+((getTime()-t)*1000).toFixed(1)+"ms";
+}
+[["Uint8Array",Uint8Array],["Int16Array",Int16Array],["Int32Array",Int32Array],
+ ["Float32Array",Float32Array],["Float64Array",Float64Array]].forEach(function(t) {
+  var T = t[1];
+  print(t[0]+":", [
+    bench("random", T, function(i) { return Math.random()*100; }),
+    bench("sorted", T, function(i) { return i; }),
+    bench("reversed", T, function(i) { return N-i; }),
+    bench("duplicates", T, function(i) { return i%4; })
+  ].join(", "));
+});
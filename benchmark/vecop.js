@@ -0,0 +1,19 @@
+// E.vecOp against the equivalent JS loop and E.mapInPlace
+var N = 1000;
+function time(fn) {
+  var t = getTime();
+  for (var n=0;n<10;n++) fn();
+  return ((getTime()-t)*100).toFixed(2)+"ms";
+}
+[["Uint8Array",Uint8Array],["Int16Array",Int16Array],["Float32Array",Float32Array]].forEach(function(t) {
+  var T = t[1], a = new T(N), b = new T(N), d = new T(N);
+  for (var i=0;i<N;i++) { a[i] = i&63; b[i] = (i*7)&63; }
+  print(t[0]+":", [
+    "JS scale "+time(function() { for (var i=0;i<N;i++) d[i] = a[i]*2; }),
+    "mapInPlace scale "+time(function() { E.mapInPlace(a, d, function(v) { return v*2; }); }),
+    "vecOp scale "+time(function() { E.vecOp(d, a, 2, "mul"); }),
+    "JS mix "+time(function() { for (var i=0;i<N;i++) d[i] = a[i]+b[i]; }),
+    "vecOp mix "+time(function() { E.vecOp(d, a, b, "add"); }),
+    "vecOp clip "+time(function() { E.vecOp(d, a, [10,50], "clip"); })
+  ].join(", "));
+});
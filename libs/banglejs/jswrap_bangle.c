@@ -907,6 +907,8 @@ void jswrap_banglejs_setLCDMode(JsVar *mode) {
     jsvUnLock(arrData);
   }
   graphicsStructResetState(&gfx); // reset colour, cliprect, etc
+  // the whole of any new offscreen buffer needs sending on the next flip
+  graphicsSetModified(&gfx, 0, 0, gfx.data.width-1, gfx.data.height-1);
   graphicsSetVar(&gfx);
   jsvUnLock(graphics);
   lcdST7789_setMode( lcdMode );
@@ -47,6 +47,14 @@ int heatshrink_var_input_cb(uint32_t *cbdata) {
   return d;
 }
 
+int heatshrink_str_input_cb(uint32_t *cbdata) {
+  JsvStringIterator *it = (JsvStringIterator *)cbdata;
+  if (!jsvStringIteratorHasChar(it)) return -1;
+  int d = (unsigned char)jsvStringIteratorGetChar(it);
+  jsvStringIteratorNext(it);
+  return d;
+}
+
 /** gets data from callback, writes to callback if nonzero. Returns total length. */
 uint32_t heatshrink_encode_cb(int (*in_callback)(uint32_t *cbdata), uint32_t *in_cbdata, void (*out_callback)(unsigned char ch, uint32_t *cbdata), uint32_t *out_cbdata) {
   heatshrink_encoder hse;
@@ -164,3 +172,79 @@ uint32_t heatshrink_decode(int (*in_callback)(uint32_t *cbdata), uint32_t *in_cb
   unsigned char *dataptr = out_data;
   return heatshrink_decode_cb(in_callback, in_cbdata, out_data?heatshrink_ptr_output_cb:NULL, out_data?(uint32_t*)&dataptr:NULL);
 }
+
+/** Feed len bytes into a streaming encoder, writing any output to the callback.
+ * If finish is set, all remaining output is flushed and the encoder must then be reset
+ * before it is used again. */
+void heatshrink_encoder_stream(heatshrink_encoder *hse, unsigned char *in_data, size_t in_len, bool finish, void (*out_callback)(unsigned char ch, uint32_t *cbdata), uint32_t *out_cbdata) {
+  uint8_t outBuf[BUFFERSIZE];
+  size_t i, count;
+  HSE_poll_res pres;
+  while (in_len || finish) {
+    if (in_len) {
+      bool ok = heatshrink_encoder_sink(hse, in_data, in_len, &count) >= 0;
+      assert(ok);NOT_USED(ok);
+      in_data += count;
+      in_len -= count;
+    } else if (heatshrink_encoder_finish(hse) == HSER_FINISH_DONE)
+      break;
+    do {
+      pres = heatshrink_encoder_poll(hse, outBuf, sizeof(outBuf), &count);
+      assert(pres >= 0);
+      for (i=0;i<count;i++)
+        out_callback(outBuf[i], out_cbdata);
+    } while (pres == HSER_POLL_MORE);
+  }
+}
+
+/** Feed len bytes into a streaming decoder, writing any output to the callback.
+ * If finish is set, all remaining output is flushed and the decoder must then be reset
+ * before it is used again. */
+void heatshrink_decoder_stream(heatshrink_decoder *hsd, unsigned char *in_data, size_t in_len, bool finish, void (*out_callback)(unsigned char ch, uint32_t *cbdata), uint32_t *out_cbdata) {
+  uint8_t outBuf[BUFFERSIZE];
+  size_t i, count;
+  HSD_poll_res pres;
+  while (in_len || finish) {
+    if (in_len) {
+      bool ok = heatshrink_decoder_sink(hsd, in_data, in_len, &count) >= 0;
+      assert(ok);NOT_USED(ok);
+      in_data += count;
+      in_len -= count;
+    } else if (heatshrink_decoder_finish(hsd) == HSDR_FINISH_DONE)
+      break;
+    do {
+      pres = heatshrink_decoder_poll(hsd, outBuf, sizeof(outBuf), &count);
+      assert(pres >= 0);
+      for (i=0;i<count;i++)
+        out_callback(outBuf[i], out_cbdata);
+    } while (pres == HSDR_POLL_MORE);
+  }
+}
+
+/** Pull up to out_len decompressed bytes out of a streaming decoder, reading compressed data from callback only
+ * when the decoder runs dry. Returns the number of bytes written, which is only less than out_len at the end of the data. */
+size_t heatshrink_decoder_read(heatshrink_decoder *hsd, int (*in_callback)(uint32_t *cbdata), uint32_t *in_cbdata, unsigned char *out_data, size_t out_len) {
+  size_t done = 0, count;
+  bool finished = false;
+  while (done < out_len) {
+    HSD_poll_res pres = heatshrink_decoder_poll(hsd, &out_data[done], out_len-done, &count);
+    assert(pres >= 0);
+    done += count;
+    if (pres == HSDR_POLL_MORE) continue;
+    // decoder is empty - feed it another byte (it always has room when empty)
+    if (finished) {
+      if (!count) break; // nothing more will come out
+      continue;
+    }
+    int d = in_callback(in_cbdata);
+    if (d < 0) {
+      finished = true;
+      if (heatshrink_decoder_finish(hsd) == HSDR_FINISH_DONE) break;
+    } else {
+      uint8_t ch = (uint8_t)d;
+      bool ok = heatshrink_decoder_sink(hsd, &ch, 1, &count) >= 0;
+      assert(ok);NOT_USED(ok);
+    }
+  }
+  return done;
+}
@@ -12,6 +12,9 @@
  * ----------------------------------------------------------------------------
  */
 
+#include "heatshrink_encoder.h"
+#include "heatshrink_decoder.h"
+
 typedef struct {
   unsigned char *ptr;
   size_t len;
@@ -21,6 +24,7 @@ void heatshrink_ptr_output_cb(unsigned char ch, uint32_t *cbdata); // takes **da
 int heatshrink_ptr_input_cb(uint32_t *cbdata); // takes *HeatShrinkPtrInputCallbackInfo
 void heatshrink_var_output_cb(unsigned char ch, uint32_t *cbdata); // takes *JsvStringIterator
 int heatshrink_var_input_cb(uint32_t *cbdata); // takes *JsvIterator
+int heatshrink_str_input_cb(uint32_t *cbdata); // takes *JsvStringIterator
 
 /** gets data from callback, writes to callback if nonzero. Returns total length. */
 uint32_t heatshrink_encode_cb(int (*in_callback)(uint32_t *cbdata), uint32_t *in_cbdata, void (*out_callback)(unsigned char ch, uint32_t *cbdata), uint32_t *out_cbdata);
@@ -33,3 +37,13 @@ uint32_t heatshrink_encode(unsigned char *in_data, size_t in_len, void (*out_cal
 
 /** gets data from callback, writes it into array if nonzero. Returns total length */
 uint32_t heatshrink_decode(int (*in_callback)(uint32_t *cbdata), uint32_t *in_cbdata, unsigned char *out_data);
+
+/** Feed data into a streaming encoder, writing output to callback. If finish is set, flush all remaining output. */
+void heatshrink_encoder_stream(heatshrink_encoder *hse, unsigned char *in_data, size_t in_len, bool finish, void (*out_callback)(unsigned char ch, uint32_t *cbdata), uint32_t *out_cbdata);
+
+/** Feed data into a streaming decoder, writing output to callback. If finish is set, flush all remaining output. */
+void heatshrink_decoder_stream(heatshrink_decoder *hsd, unsigned char *in_data, size_t in_len, bool finish, void (*out_callback)(unsigned char ch, uint32_t *cbdata), uint32_t *out_cbdata);
+
+/** Pull up to out_len decompressed bytes out of a streaming decoder, reading compressed data from callback only
+ * when the decoder runs dry. Returns the number of bytes written, which is only less than out_len at the end of the data. */
+size_t heatshrink_decoder_read(heatshrink_decoder *hsd, int (*in_callback)(uint32_t *cbdata), uint32_t *in_cbdata, unsigned char *out_data, size_t out_len);
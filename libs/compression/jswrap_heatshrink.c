@@ -18,6 +18,7 @@
 #include "compress_heatshrink.h"
 #include "jswrap_heatshrink.h"
 #include "jsparse.h"
+#include "jsinteractive.h"
 
 
 /*JSON{
@@ -29,7 +30,15 @@ Simple library for compression/decompression using [heatshrink](https://github.c
 
 Espruino uses heatshrink internally to compress RAM down to fit in Flash memory when `save()` is used. This just exposes that functionality.
 
-Functions here take and return buffers of data. There is no support for streaming, so both the compressed and decompressed data must be able to fit in memory at the same time.
+`compress` and `decompress` take and return buffers of data, so both the compressed and decompressed data must be able to fit in memory at the same time.
+
+To handle data that is bigger than the available memory, use the streaming `Compressor` and `Decompressor` objects instead:
+
+```
+var c = new (require("heatshrink").Compressor)();
+c.pipe(require("fs").openFile("log.hs","w"));
+E.pipe(require("fs").openFile("log.txt","r"), c);
+```
 */
 
 
@@ -117,3 +126,283 @@ JsVar *jswrap_heatshrink_decompress(JsVar *data) {
   jsvUnLock(outVar);
   return ab;
 }
+
+/*JSON{
+  "type" : "class",
+  "library" : "heatshrink",
+  "class" : "Compressor",
+  "ifndef" : "SAVE_ON_FLASH"
+}
+A streaming heatshrink compressor. Data passed to `write` is compressed a bit at a
+time and emitted as `data` events (or written straight to the destination given to `pipe`),
+so only a small amount of state needs to be kept in memory.
+
+The compressed data is compatible with `require("heatshrink").decompress`.
+*/
+/*JSON{
+  "type" : "class",
+  "library" : "heatshrink",
+  "class" : "Decompressor",
+  "ifndef" : "SAVE_ON_FLASH"
+}
+A streaming heatshrink decompressor - the opposite of `Compressor`.
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "Compressor",
+  "name" : "data",
+  "params" : [
+    ["data","JsVar","A String containing compressed data"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Called when compressed data is available (if `pipe` hasn't been used)
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "Compressor",
+  "name" : "end",
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Called after `end` has been called and all the data has been emitted
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "Decompressor",
+  "name" : "data",
+  "params" : [
+    ["data","JsVar","A String containing decompressed data"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Called when decompressed data is available (if `pipe` hasn't been used)
+*/
+/*JSON{
+  "type" : "event",
+  "class" : "Decompressor",
+  "name" : "end",
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Called after `end` has been called and all the data has been emitted
+*/
+
+#define HEATSHRINK_STATE_NAME JS_HIDDEN_CHAR_STR"hs"
+#define HEATSHRINK_DEST_NAME JS_HIDDEN_CHAR_STR"dst"
+
+static JsVar *jswrap_heatshrink_stream_new(const char *className, size_t stateSize, bool decode) {
+  JsVar *obj = jspNewObject(0, className);
+  JsVar *state = jsvNewFlatStringOfLength((unsigned int)stateSize);
+  if (!obj || !state) {
+    jsvUnLock2(obj, state);
+    jsError("Not enough memory for heatshrink state");
+    return 0;
+  }
+  if (decode) heatshrink_decoder_reset((heatshrink_decoder*)jsvGetFlatStringPointer(state));
+  else heatshrink_encoder_reset((heatshrink_encoder*)jsvGetFlatStringPointer(state));
+  jsvObjectSetChildAndUnLock(obj, HEATSHRINK_STATE_NAME, state);
+  return obj;
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "heatshrink",
+  "name" : "Compressor",
+  "generate" : "jswrap_heatshrink_compressor_constructor",
+  "return" : ["JsVar","A new Compressor"],
+  "return_object" : "Compressor",
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Create a streaming compressor, for use as `new (require("heatshrink").Compressor)()`.
+See `Compressor` for more information.
+*/
+JsVar *jswrap_heatshrink_compressor_constructor() {
+  return jswrap_heatshrink_stream_new("Compressor", sizeof(heatshrink_encoder), false);
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "heatshrink",
+  "name" : "Decompressor",
+  "generate" : "jswrap_heatshrink_decompressor_constructor",
+  "return" : ["JsVar","A new Decompressor"],
+  "return_object" : "Decompressor",
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Create a streaming decompressor, for use as `new (require("heatshrink").Decompressor)()`.
+See `Decompressor` for more information.
+*/
+JsVar *jswrap_heatshrink_decompressor_constructor() {
+  return jswrap_heatshrink_stream_new("Decompressor", sizeof(heatshrink_decoder), true);
+}
+
+/// Output callback for streaming - appends to the string iterator
+static void jswrap_heatshrink_stream_output_cb(unsigned char ch, uint32_t *cbdata) {
+  JsvStringIterator *it = (JsvStringIterator *)cbdata;
+  jsvStringIteratorAppend(it, (char)ch);
+}
+
+/// Send data either to the piped destination, or as a 'data' event
+static void jswrap_heatshrink_stream_emit(JsVar *parent, JsVar *data) {
+  JsVar *dest = jsvObjectGetChild(parent, HEATSHRINK_DEST_NAME, 0);
+  if (dest) {
+    JsVar *writeFunc = jspGetNamedField(dest, "write", false);
+    if (jsvIsFunction(writeFunc))
+      jsvUnLock(jspExecuteFunction(writeFunc, dest, 1, &data));
+    jsvUnLock2(writeFunc, dest);
+  } else {
+    jsiQueueObjectCallbacks(parent, JS_EVENT_PREFIX"data", &data, 1);
+  }
+}
+
+/** Push data (which may be undefined) through the encoder/decoder, emitting the output.
+ * If finish is set, everything is flushed out and the state freed */
+void jswrap_heatshrink_stream_write(JsVar *parent, JsVar *data, bool decode, bool finish) {
+  JsVar *state = jsvObjectGetChild(parent, HEATSHRINK_STATE_NAME, 0);
+  if (!jsvIsFlatString(state)) {
+    jsvUnLock(state);
+    jsExceptionHere(JSET_ERROR, "Stream has already ended");
+    return;
+  }
+  if (!jsvIsUndefined(data) && !jsvIsIterable(data)) {
+    jsvUnLock(state);
+    jsExceptionHere(JSET_TYPEERROR,"Expecting something iterable, got %t",data);
+    return;
+  }
+  JsVar *outVar = jsvNewFromEmptyString();
+  if (!outVar) {
+    jsvUnLock(state);
+    return; // out of memory
+  }
+  JsvStringIterator out_it;
+  jsvStringIteratorNew(&out_it, outVar, 0);
+  /* The state is re-read each time as it's only guaranteed not to move while we're
+   * in here. Data is read into a small buffer first as iterating over a generic
+   * JsVar byte by byte is slow. */
+  unsigned char buf[64];
+  size_t bufLen = 0;
+  JsvIterator in_it;
+  bool hasData = !jsvIsUndefined(data);
+  if (hasData) jsvIteratorNew(&in_it, data, JSIF_EVERY_ARRAY_ELEMENT);
+  bool more = hasData;
+  while (more || finish) {
+    more = hasData && jsvIteratorHasElement(&in_it);
+    if (more) {
+      buf[bufLen++] = (unsigned char)jsvIteratorGetIntegerValue(&in_it);
+      jsvIteratorNext(&in_it);
+      if (bufLen<sizeof(buf)) continue;
+    }
+    void *hs = jsvGetFlatStringPointer(state);
+    bool flush = finish && !more;
+    if (decode) heatshrink_decoder_stream((heatshrink_decoder*)hs, buf, bufLen, flush, jswrap_heatshrink_stream_output_cb, (uint32_t*)&out_it);
+    else heatshrink_encoder_stream((heatshrink_encoder*)hs, buf, bufLen, flush, jswrap_heatshrink_stream_output_cb, (uint32_t*)&out_it);
+    bufLen = 0;
+    if (flush) break;
+  }
+  if (hasData) jsvIteratorFree(&in_it);
+  jsvStringIteratorFree(&out_it);
+  jsvUnLock(state);
+
+  if (jsvGetStringLength(outVar))
+    jswrap_heatshrink_stream_emit(parent, outVar);
+  jsvUnLock(outVar);
+  if (finish) {
+    jsvObjectRemoveChild(parent, HEATSHRINK_STATE_NAME);
+    JsVar *dest = jsvObjectGetChild(parent, HEATSHRINK_DEST_NAME, 0);
+    if (dest) {
+      JsVar *endFunc = jspGetNamedField(dest, "end", false);
+      if (jsvIsFunction(endFunc))
+        jsvUnLock(jspExecuteFunction(endFunc, dest, 0, 0));
+      jsvUnLock2(endFunc, dest);
+      jsvObjectRemoveChild(parent, HEATSHRINK_DEST_NAME);
+    }
+    jsiQueueObjectCallbacks(parent, JS_EVENT_PREFIX"end", 0, 0);
+  }
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Compressor",
+  "name" : "write",
+  "generate_full" : "jswrap_heatshrink_stream_write(parent, data, false, false)",
+  "params" : [
+    ["data","JsVar","The data to compress"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Compress some data. The output may not be emitted until more data has been written, or `end` is called.
+*/
+/*JSON{
+  "type" : "method",
+  "class" : "Compressor",
+  "name" : "end",
+  "generate_full" : "jswrap_heatshrink_stream_write(parent, data, false, true)",
+  "params" : [
+    ["data","JsVar","[optional] Any final data to compress"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Finish compressing - all remaining data is emitted, followed by an `end` event.
+If `pipe` was used, `end` is also called on the destination.
+*/
+/*JSON{
+  "type" : "method",
+  "class" : "Decompressor",
+  "name" : "write",
+  "generate_full" : "jswrap_heatshrink_stream_write(parent, data, true, false)",
+  "params" : [
+    ["data","JsVar","The data to decompress"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Decompress some data. The output may not be emitted until more data has been written, or `end` is called.
+*/
+/*JSON{
+  "type" : "method",
+  "class" : "Decompressor",
+  "name" : "end",
+  "generate_full" : "jswrap_heatshrink_stream_write(parent, data, true, true)",
+  "params" : [
+    ["data","JsVar","[optional] Any final data to decompress"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Finish decompressing - all remaining data is emitted, followed by an `end` event.
+If `pipe` was used, `end` is also called on the destination.
+*/
+
+/*JSON{
+  "type" : "method",
+  "class" : "Compressor",
+  "name" : "pipe",
+  "generate" : "jswrap_heatshrink_stream_pipe",
+  "params" : [
+    ["destination","JsVar","An object with `write` (and optionally `end`) methods"]
+  ],
+  "return" : ["JsVar","The destination"],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Write all output directly to `destination.write` rather than emitting `data` events,
+and call `destination.end()` when this stream ends.
+*/
+/*JSON{
+  "type" : "method",
+  "class" : "Decompressor",
+  "name" : "pipe",
+  "generate" : "jswrap_heatshrink_stream_pipe",
+  "params" : [
+    ["destination","JsVar","An object with `write` (and optionally `end`) methods"]
+  ],
+  "return" : ["JsVar","The destination"],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Write all output directly to `destination.write` rather than emitting `data` events,
+and call `destination.end()` when this stream ends.
+*/
+JsVar *jswrap_heatshrink_stream_pipe(JsVar *parent, JsVar *destination) {
+  if (!jsvIsObject(destination)) {
+    jsExceptionHere(JSET_TYPEERROR,"Expecting an Object, got %t",destination);
+    return 0;
+  }
+  jsvObjectSetChild(parent, HEATSHRINK_DEST_NAME, destination);
+  return jsvLockAgain(destination);
+}
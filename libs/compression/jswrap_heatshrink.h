@@ -15,3 +15,8 @@
 
 JsVar *jswrap_heatshrink_compress(JsVar *data);
 JsVar *jswrap_heatshrink_decompress(JsVar *data);
+
+JsVar *jswrap_heatshrink_compressor_constructor();
+JsVar *jswrap_heatshrink_decompressor_constructor();
+void jswrap_heatshrink_stream_write(JsVar *parent, JsVar *data, bool decode, bool finish);
+JsVar *jswrap_heatshrink_stream_pipe(JsVar *parent, JsVar *destination);
@@ -37,6 +37,9 @@
 #ifdef USE_LCD_ST7789_8BIT
 #include "lcd_st7789_8bit.h"
 #endif
+#ifdef USE_LCD_LINUX
+#include "lcd_linux.h"
+#endif
 
 // ----------------------------------------------------------------------------------------------
 
@@ -89,10 +92,7 @@ void graphicsFallbackScroll(JsGraphics *gfx, int xdir, int ydir) {
       graphicsFallbackScrollX(gfx, xdir, y, y+ydir);
   }
 #ifndef SAVE_ON_FLASH
-  gfx->data.modMinX=0;
-  gfx->data.modMinY=0;
-  gfx->data.modMaxX=(short)(gfx->data.width-1);
-  gfx->data.modMaxY=(short)(gfx->data.height-1);
+  graphicsSetModified(gfx, 0, 0, gfx->data.width-1, gfx->data.height-1);
 #endif
 }
 
@@ -123,12 +123,10 @@ void graphicsStructInit(JsGraphics *gfx, int width, int height, int bpp) {
   gfx->data.bpp = (unsigned char)bpp;
   graphicsStructResetState(gfx);
 #ifndef SAVE_ON_FLASH
-  gfx->data.modMaxX = -32768;
-  gfx->data.modMaxY = -32768;
-  gfx->data.modMinX = 32767;
-  gfx->data.modMinY = 32767;
+  graphicsResetModified(gfx);
+  gfx->data.flipCount = 0;
+  gfx->data.flipBytes = 0;
 #endif
-
 }
 
 bool graphicsGetFromVar(JsGraphics *gfx, JsVar *parent) {
@@ -142,6 +140,7 @@ bool graphicsGetFromVar(JsGraphics *gfx, JsVar *parent) {
     gfx->getPixel = graphicsFallbackGetPixel;
     gfx->fillRect = graphicsFallbackFillRect;
     gfx->scroll = graphicsFallbackScroll;
+    gfx->blitRow = 0;
 #ifdef USE_LCD_SDL
     if (gfx->data.type == JSGRAPHICSTYPE_SDL) {
       lcdSetCallbacks_SDL(gfx);
@@ -165,6 +164,10 @@ bool graphicsGetFromVar(JsGraphics *gfx, JsVar *parent) {
 #ifdef USE_LCD_ST7789_8BIT
     } else if (gfx->data.type == JSGRAPHICSTYPE_ST7789_8BIT) {
       lcdST7789_setCallbacks(gfx);
+#endif
+#ifdef USE_LCD_LINUX
+    } else if (gfx->data.type == JSGRAPHICSTYPE_LINUXFB) {
+      lcdSetCallbacks_Framebuffer_Linux(gfx);
 #endif
     } else {
       jsExceptionHere(JSET_INTERNALERROR, "Unknown graphics type\n");
@@ -209,6 +212,95 @@ void graphicsToDeviceCoordinates(const JsGraphics *gfx, int *x, int *y) {
 
 // ----------------------------------------------------------------------------------------------
 
+#ifndef SAVE_ON_FLASH
+static int graphicsModRectArea(const JsGraphicsModRect *r) {
+  return (r->x2+1-r->x1) * (r->y2+1-r->y1);
+}
+
+/// Set a to the bounding box of a and b
+static void graphicsModRectMerge(JsGraphicsModRect *a, const JsGraphicsModRect *b) {
+  if (b->x1 < a->x1) a->x1 = b->x1;
+  if (b->y1 < a->y1) a->y1 = b->y1;
+  if (b->x2 > a->x2) a->x2 = b->x2;
+  if (b->y2 > a->y2) a->y2 = b->y2;
+}
+
+/// How many more pixels we'd send if a and b were merged into one region (may be negative if they overlap)
+static int graphicsModRectMergeCost(const JsGraphicsModRect *a, const JsGraphicsModRect *b) {
+  JsGraphicsModRect m = *a;
+  graphicsModRectMerge(&m, b);
+  return graphicsModRectArea(&m) - (graphicsModRectArea(a) + graphicsModRectArea(b));
+}
+
+/// Is merging a and b cheap enough that we should just send them as one region?
+static bool graphicsModRectShouldMerge(const JsGraphicsModRect *a, const JsGraphicsModRect *b) {
+  int areas = graphicsModRectArea(a) + graphicsModRectArea(b);
+  return graphicsModRectMergeCost(a, b) <= (areas>>2) + GRAPHICS_MOD_MERGE_SLACK;
+}
+
+void graphicsSetModified(JsGraphics *gfx, int x1, int y1, int x2, int y2) {
+  if (x1>x2 || y1>y2) return;
+  if (x1 < gfx->data.modMinX) gfx->data.modMinX=(short)x1;
+  if (x2 > gfx->data.modMaxX) gfx->data.modMaxX=(short)x2;
+  if (y1 < gfx->data.modMinY) gfx->data.modMinY=(short)y1;
+  if (y2 > gfx->data.modMaxY) gfx->data.modMaxY=(short)y2;
+  JsGraphicsModRect *rects = gfx->data.modRects;
+  int n = gfx->data.modRectCount;
+  int i, j;
+  // fast path - already inside a modified region (eg. drawing pixels of a line)
+  for (i=0;i<n;i++)
+    if (x1>=rects[i].x1 && y1>=rects[i].y1 && x2<=rects[i].x2 && y2<=rects[i].y2)
+      return;
+  JsGraphicsModRect r;
+  r.x1 = (short)x1;
+  r.y1 = (short)y1;
+  r.x2 = (short)x2;
+  r.y2 = (short)y2;
+  /* Absorb any regions that are close to this one. The merged region
+  may now be close to one we already checked, so start again if we merge */
+  i = 0;
+  while (i<n) {
+    if (graphicsModRectShouldMerge(&rects[i], &r)) {
+      graphicsModRectMerge(&r, &rects[i]);
+      rects[i] = rects[--n];
+      i = 0;
+    } else i++;
+  }
+  if (n < GRAPHICS_MOD_RECTS) {
+    rects[n++] = r;
+  } else {
+    // Out of regions - merge whichever pair (including the new region, index n) wastes the fewest pixels
+    int bestA = 0, bestB = n;
+    int bestCost = graphicsModRectMergeCost(&rects[0], &r);
+    for (i=0;i<n;i++) {
+      for (j=i+1;j<=n;j++) {
+        int cost = graphicsModRectMergeCost(&rects[i], (j==n) ? &r : &rects[j]);
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestA = i;
+          bestB = j;
+        }
+      }
+    }
+    if (bestB==n) {
+      graphicsModRectMerge(&rects[bestA], &r);
+    } else {
+      graphicsModRectMerge(&rects[bestA], &rects[bestB]);
+      rects[bestB] = r;
+    }
+  }
+  gfx->data.modRectCount = (unsigned char)n;
+}
+
+void graphicsResetModified(JsGraphics *gfx) {
+  gfx->data.modMaxX = -32768;
+  gfx->data.modMaxY = -32768;
+  gfx->data.modMinX = 32767;
+  gfx->data.modMinY = 32767;
+  gfx->data.modRectCount = 0;
+}
+#endif
+
 static void graphicsSetPixelDevice(JsGraphics *gfx, int x, int y, unsigned int col) {
 #ifdef SAVE_ON_FLASH
   if (x<0 || y<0 || x>=gfx->data.width || y>=gfx->data.height) return;
@@ -219,10 +311,7 @@ static void graphicsSetPixelDevice(JsGraphics *gfx, int x, int y, unsigned int c
       y>gfx->data.clipRect.y2) return;
 #endif
 #ifndef SAVE_ON_FLASH
-  if (x < gfx->data.modMinX) gfx->data.modMinX=(short)x;
-  if (x > gfx->data.modMaxX) gfx->data.modMaxX=(short)x;
-  if (y < gfx->data.modMinY) gfx->data.modMinY=(short)y;
-  if (y > gfx->data.modMaxY) gfx->data.modMaxY=(short)y;
+  graphicsSetModified(gfx, x, y, x, y);
 #endif
   gfx->setPixel(gfx,(int)x,(int)y,col & (unsigned int)((1L<<gfx->data.bpp)-1));
 }
@@ -256,10 +345,7 @@ static void graphicsFillRectDevice(JsGraphics *gfx, int x1, int y1, int x2, int
 #endif
   if (x2<x1 || y2<y1) return; // nope
 #ifndef SAVE_ON_FLASH
-  if (x1 < gfx->data.modMinX) gfx->data.modMinX=(short)x1;
-  if (x2 > gfx->data.modMaxX) gfx->data.modMaxX=(short)x2;
-  if (y1 < gfx->data.modMinY) gfx->data.modMinY=(short)y1;
-  if (y2 > gfx->data.modMaxY) gfx->data.modMaxY=(short)y2;
+  graphicsSetModified(gfx, x1, y1, x2, y2);
 #endif
   if (x1==x2 && y1==y2) {
     gfx->setPixel(gfx,(int)x1,(int)y1,col);
@@ -370,6 +456,11 @@ void graphicsFillEllipse(JsGraphics *gfx, int posX1, int posY1, int posX2, int p
 void graphicsDrawLine(JsGraphics *gfx, int x1, int y1, int x2, int y2) {
   graphicsToDeviceCoordinates(gfx, &x1, &y1);
   graphicsToDeviceCoordinates(gfx, &x2, &y2);
+  // horizontal or vertical lines are just a span - let the device fill them in one go
+  if (x1==x2 || y1==y2) {
+    graphicsFillRectDevice(gfx, x1, y1, x2, y2, gfx->data.fgColor);
+    return;
+  }
 
   int xl = x2-x1;
   int yl = y2-y1;
@@ -405,6 +496,234 @@ void graphicsDrawLine(JsGraphics *gfx, int x1, int y1, int x2, int y2) {
 }
 
 
+#ifdef GRAPHICS_ANTIALIAS
+unsigned int graphicsBlendColor(JsGraphics *gfx, unsigned int a, unsigned int b, int amt) {
+  if (gfx->data.bpp==16) { // RGB565
+    int ar = (int)(a>>11)&31, ag = (int)(a>>5)&63, ab = (int)a&31;
+    int br = (int)(b>>11)&31, bg = (int)(b>>5)&63, bb = (int)b&31;
+    ar += ((br-ar)*amt)>>8;
+    ag += ((bg-ag)*amt)>>8;
+    ab += ((bb-ab)*amt)>>8;
+    return (unsigned int)((ar<<11) | (ag<<5) | ab);
+  } else if (gfx->data.bpp>=24) { // 8 bits per channel
+    unsigned int col = 0;
+    int sh;
+    for (sh=0;sh<24;sh+=8) {
+      int ac = (int)(a>>sh)&255, bc = (int)(b>>sh)&255;
+      col |= (unsigned int)(ac + (((bc-ac)*amt)>>8)) << sh;
+    }
+    return col;
+  } else { // greyscale
+    return (unsigned int)((int)a + ((((int)b-(int)a)*amt)>>8));
+  }
+}
+
+/// Draw the foreground colour over the pixel at x,y (USER coords) with coverage 0..1
+static void graphicsBlendPixel(JsGraphics *gfx, int x, int y, double coverage) {
+  int amt = (int)(coverage*256 + 0.5);
+  if (amt<=0) return;
+  graphicsToDeviceCoordinates(gfx, &x, &y);
+  unsigned int col = gfx->data.fgColor;
+  if (amt<256) col = graphicsBlendColor(gfx, graphicsGetPixelDevice(gfx, x, y), col, amt);
+  graphicsSetPixelDevice(gfx, x, y, col);
+}
+
+static double graphicsFrac(double v) {
+  return v - floor(v);
+}
+
+/* Xiaolin Wu's line algorithm - two pixels per step, with the
+ * intensity of each given by how close it is to the real line */
+void graphicsDrawLineAA(JsGraphics *gfx, double x1, double y1, double x2, double y2) {
+  if (gfx->data.bpp<4) { // not enough colours to blend with
+    graphicsDrawLine(gfx, (int)floor(x1+0.5), (int)floor(y1+0.5), (int)floor(x2+0.5), (int)floor(y2+0.5));
+    return;
+  }
+  bool steep = fabs(y2-y1) > fabs(x2-x1);
+  double t;
+  if (steep) { // always scan along x
+    t = x1; x1 = y1; y1 = t;
+    t = x2; x2 = y2; y2 = t;
+  }
+  if (x1>x2) {
+    t = x1; x1 = x2; x2 = t;
+    t = y1; y1 = y2; y2 = t;
+  }
+  double dx = x2-x1;
+  double gradient = (dx==0) ? 1 : (y2-y1)/dx;
+  // first end point
+  double xend = floor(x1+0.5);
+  double yend = y1 + gradient*(xend-x1);
+  double xgap = 1 - graphicsFrac(x1+0.5);
+  int xp1 = (int)xend, yp = (int)floor(yend);
+  if (steep) {
+    graphicsBlendPixel(gfx, yp, xp1, (1-graphicsFrac(yend))*xgap);
+    graphicsBlendPixel(gfx, yp+1, xp1, graphicsFrac(yend)*xgap);
+  } else {
+    graphicsBlendPixel(gfx, xp1, yp, (1-graphicsFrac(yend))*xgap);
+    graphicsBlendPixel(gfx, xp1, yp+1, graphicsFrac(yend)*xgap);
+  }
+  double intery = yend + gradient;
+  // second end point
+  xend = floor(x2+0.5);
+  yend = y2 + gradient*(xend-x2);
+  xgap = graphicsFrac(x2+0.5);
+  int xp2 = (int)xend;
+  yp = (int)floor(yend);
+  if (xp2==xp1) return; // it's all one pixel
+  if (steep) {
+    graphicsBlendPixel(gfx, yp, xp2, (1-graphicsFrac(yend))*xgap);
+    graphicsBlendPixel(gfx, yp+1, xp2, graphicsFrac(yend)*xgap);
+  } else {
+    graphicsBlendPixel(gfx, xp2, yp, (1-graphicsFrac(yend))*xgap);
+    graphicsBlendPixel(gfx, xp2, yp+1, graphicsFrac(yend)*xgap);
+  }
+  // everything in between
+  int x;
+  for (x=xp1+1;x<xp2;x++) {
+    int y = (int)floor(intery);
+    double f = intery - y;
+    if (steep) {
+      graphicsBlendPixel(gfx, y, x, 1-f);
+      graphicsBlendPixel(gfx, y+1, x, f);
+    } else {
+      graphicsBlendPixel(gfx, x, y, 1-f);
+      graphicsBlendPixel(gfx, x, y+1, f);
+    }
+    intery += gradient;
+  }
+}
+
+/* Each pixel within 1px of the circle gets an intensity from its distance
+ * to it. Rows are scanned so only the pixels near the circle are visited,
+ * and each is only drawn once. */
+void graphicsDrawCircleAA(JsGraphics *gfx, double cx, double cy, double r) {
+  if (r<0) r = -r;
+  if (gfx->data.bpp<4) { // not enough colours to blend with
+    int x = (int)floor(cx+0.5), y = (int)floor(cy+0.5), ir = (int)floor(r+0.5);
+    graphicsDrawEllipse(gfx, x-ir, y-ir, x+ir, y+ir);
+    return;
+  }
+  double ro = r+1, ri = r-1;
+  int py;
+  for (py=(int)floor(cy-ro);py<=(int)ceil(cy+ro);py++) {
+    double dy = py - cy;
+    double dy2 = dy*dy;
+    if (dy2 > ro*ro) continue;
+    double xo = sqrt(ro*ro - dy2);
+    // pixels closer than xi to the centre line are inside the ring
+    double xi = (ri>0 && dy2 < ri*ri) ? sqrt(ri*ri - dy2) : -1;
+    int left2 = (int)floor(cx - xi), right1 = (int)ceil(cx + xi);
+    int px;
+    for (px=(int)ceil(cx-xo);px<=(int)floor(cx+xo);px++) {
+      if (xi>=0 && px>left2 && px<right1) px = right1; // skip the inside
+      double dx = px - cx;
+      double d = fabs(sqrt(dx*dx + dy2) - r);
+      if (d<1) graphicsBlendPixel(gfx, px, py, 1-d);
+    }
+  }
+}
+
+/* Flatten the curve into line segments. The number of segments comes from how
+ * far the control points bend the curve, so the error is always below 1/4 px,
+ * and points are stepped along with forward differences. */
+void graphicsDrawBezier(JsGraphics *gfx, int points, const double *xy, bool antialias) {
+  double ddx, ddy, dd;
+  if (points==3) {
+    ddx = xy[0] - 2*xy[2] + xy[4];
+    ddy = xy[1] - 2*xy[3] + xy[5];
+    dd = sqrt(ddx*ddx + ddy*ddy) / 4; // max distance from a chord is dd/n^2
+  } else if (points==4) {
+    double d1x = xy[0] - 2*xy[2] + xy[4], d1y = xy[1] - 2*xy[3] + xy[5];
+    double d2x = xy[2] - 2*xy[4] + xy[6], d2y = xy[3] - 2*xy[5] + xy[7];
+    double d1 = d1x*d1x + d1y*d1y, d2 = d2x*d2x + d2y*d2y;
+    dd = sqrt(d1>d2 ? d1 : d2) * 3 / 4; // (an upper bound)
+  } else return;
+  int n = (int)ceil(sqrt(dd * 4)); // 4 = 1/tolerance
+  if (n<1) n = 1;
+  if (n>256) n = 256;
+  double h = 1.0 / n;
+  // forward differences for x(t) and y(t)
+  double px = xy[0], py = xy[1];
+  double fx[3], fy[3];
+  int c;
+  for (c=0;c<2;c++) {
+    double p0 = xy[c], p1 = xy[2+c], p2 = xy[4+c];
+    double *f = c ? fy : fx;
+    if (points==3) {
+      double a = p0 - 2*p1 + p2, b = 2*(p1 - p0);
+      f[0] = a*h*h + b*h;
+      f[1] = 2*a*h*h;
+      f[2] = 0;
+    } else {
+      double p3 = xy[6+c];
+      double a = -p0 + 3*p1 - 3*p2 + p3, b = 3*(p0 - 2*p1 + p2), cc = 3*(p1 - p0);
+      f[0] = a*h*h*h + b*h*h + cc*h;
+      f[1] = 6*a*h*h*h + 2*b*h*h;
+      f[2] = 6*a*h*h*h;
+    }
+  }
+  int i;
+  for (i=1;i<=n;i++) {
+    double nx, ny;
+    if (i==n) { // land exactly on the end point
+      nx = xy[points*2-2];
+      ny = xy[points*2-1];
+    } else {
+      nx = px + fx[0];
+      ny = py + fy[0];
+      fx[0] += fx[1]; fx[1] += fx[2];
+      fy[0] += fy[1]; fy[1] += fy[2];
+    }
+    if (antialias)
+      graphicsDrawLineAA(gfx, px, py, nx, ny);
+    else
+      graphicsDrawLine(gfx, (int)floor(px+0.5), (int)floor(py+0.5), (int)floor(nx+0.5), (int)floor(ny+0.5));
+    px = nx;
+    py = ny;
+  }
+}
+#endif
+
+
+/* An edge of a polygon, for graphicsFillPoly. X is stepped incrementally
+ * from one scanline to the next. x = x0 + (y-y0)*dx/dy is kept as a floored
+ * quotient and remainder (q,r) so we don't have to divide each scanline,
+ * and then rounded towards zero to match what the division would give. */
+typedef struct {
+  short yStart, yEnd; ///< first and last scanlines this edge crosses
+  short x0; ///< x of the start vertex of the edge
+  short index; ///< edge number, used to keep the sort order stable
+  bool down; ///< edge's direction (used for the winding rule)
+  int q, r; ///< (y-y0)*dx/|dy| as floored quotient and remainder
+  int dq, dr; ///< amount to add to q/r each scanline
+  int len; ///< |dy|
+  short x; ///< x for the current scanline
+} GraphicsPolyEdge;
+
+static void graphicsPolyEdgeUpdateX(GraphicsPolyEdge *e) {
+  e->x = (short)(e->x0 + ((e->q<0 && e->r) ? e->q+1 : e->q));
+}
+
+static void graphicsPolyEdgeNext(GraphicsPolyEdge *e) {
+  e->q += e->dq;
+  e->r += e->dr;
+  if (e->r >= e->len) {
+    e->r -= e->len;
+    e->q++;
+  }
+  graphicsPolyEdgeUpdateX(e);
+}
+
+/// Floored division and modulo (r is always >=0)
+static void graphicsFloorDivMod(int n, int d, int *q, int *r) {
+  *q = n / d;
+  *r = n % d;
+  if (*r<0) {
+    *r += d;
+    (*q)--;
+  }
+}
 
 void graphicsFillPoly(JsGraphics *gfx, int points, short *vertices) {
   typedef struct {
@@ -434,57 +753,292 @@ void graphicsFillPoly(JsGraphics *gfx, int points, short *vertices) {
   if (miny<0) miny=0;
   if (maxy>=gfx->data.height) maxy=(int)(gfx->data.height-1);
 #endif
+  if (points<2 || miny>maxy) return;
 
-  const int MAX_CROSSES = 64;
-
-  // for each scanline
-  for (y=miny;y<=maxy;y++) {
-    short cross[MAX_CROSSES];
-    bool slopes[MAX_CROSSES];
-    int crosscnt = 0;
-    // work out all the times lines cross the scanline
-    j = points-1;
-    for (i=0;i<points;i++) {
-      if ((y==miny && (v[i].y==y || v[j].y==y)) || // special-case top line
-          (v[i].y<y && v[j].y>=y) ||
-          (v[j].y<y && v[i].y>=y)) {
-        if (crosscnt < MAX_CROSSES) {
-          int l = v[j].y - v[i].y;
-          if (l) { // don't do horiz lines - rely on the ends of the lines that join onto them
-            cross[crosscnt] = (short)(v[i].x + ((y - v[i].y) * (v[j].x-v[i].x)) / l);
-            slopes[crosscnt] = (l>1)?1:0;
-            crosscnt++;
-          }
-        }
-      }
-      j = i;
+  /* Build the edge table. An edge crosses scanline y if y is in (top,bottom],
+   * and on the first scanline we also include edges that start on it. Horizontal
+   * edges are skipped - we rely on the ends of the edges that join onto them. */
+  GraphicsPolyEdge edges[points];
+  GraphicsPolyEdge *active[points];
+  int edgeCount = 0;
+  j = points-1;
+  for (i=0;i<points;i++) {
+    int l = v[j].y - v[i].y;
+    int top = (l>0) ? v[i].y : v[j].y;
+    int bottom = (l>0) ? v[j].y : v[i].y;
+    int yStart = (top<=miny) ? miny : top+1;
+    int yEnd = (bottom>maxy) ? maxy : bottom;
+    if (l && yStart<=yEnd) {
+      GraphicsPolyEdge *e = &edges[edgeCount++];
+      e->yStart = (short)yStart;
+      e->yEnd = (short)yEnd;
+      e->x0 = v[i].x;
+      e->index = (short)i;
+      e->down = l>1;
+      e->len = (l>0) ? l : -l;
+      int dx = (l>0) ? (v[j].x-v[i].x) : (v[i].x-v[j].x);
+      graphicsFloorDivMod((yStart - v[i].y) * dx, e->len, &e->q, &e->r);
+      graphicsFloorDivMod(dx, e->len, &e->dq, &e->dr);
+      graphicsPolyEdgeUpdateX(e);
     }
+    j = i;
+  }
+  // sort edges by the scanline they start on, so we can just walk through them
+  for (i=1;i<edgeCount;i++) {
+    GraphicsPolyEdge e = edges[i];
+    for (j=i;j>0 && edges[j-1].yStart>e.yStart;j--)
+      edges[j] = edges[j-1];
+    edges[j] = e;
+  }
 
-    // bubble sort
-    for (i=0;i<crosscnt-1;) {
-      if (cross[i]>cross[i+1]) {
-        short t=cross[i];
-        cross[i]=cross[i+1];
-        cross[i+1]=t;
-        bool ts=slopes[i];
-        slopes[i]=slopes[i+1];
-        slopes[i+1]=ts;
-        if (i) i--;
-      } else i++;
+  int nextEdge = 0;
+  int activeCount = 0;
+  for (y=miny;y<=maxy;y++) {
+    // add any edges that start on this scanline, and remove ones that have finished
+    while (nextEdge<edgeCount && edges[nextEdge].yStart<=y)
+      active[activeCount++] = &edges[nextEdge++];
+    j = 0;
+    for (i=0;i<activeCount;i++)
+      if (active[i]->yEnd>=y) active[j++] = active[i];
+    activeCount = j;
+    /* Insertion sort by x - the order barely changes from one scanline
+     * to the next so this is fast. Ties are ordered by edge index. */
+    for (i=1;i<activeCount;i++) {
+      GraphicsPolyEdge *e = active[i];
+      for (j=i;j>0 && (active[j-1]->x>e->x || (active[j-1]->x==e->x && active[j-1]->index>e->index));j--)
+        active[j] = active[j-1];
+      active[j] = e;
     }
 
     //  Fill the pixels between node pairs.
     int x = 0,s = 0;
-    for (i=0;i<crosscnt;i++) {
-      if (s==0) x=cross[i];
-      if (slopes[i]) s++; else s--;
-      if (!s || i==crosscnt-1) graphicsFillRectDevice(gfx,x,y,cross[i],y,gfx->data.fgColor);
-      if (jspIsInterrupted()) break;
+    for (i=0;i<activeCount;i++) {
+      GraphicsPolyEdge *e = active[i];
+      if (s==0) x=e->x;
+      if (e->down) s++; else s--;
+      if (!s || i==activeCount-1) graphicsFillRectDevice(gfx,x,y,e->x,y,gfx->data.fgColor);
     }
+    if (jspIsInterrupted()) break;
+    // step edges on to the next scanline
+    for (i=0;i<activeCount;i++)
+      graphicsPolyEdgeNext(active[i]);
   }
 }
 
 #ifndef NO_VECTOR_FONT
+/// Fill the polygons that make up a vector font character
+static void graphicsFillVectorCharPolys(JsGraphics *gfx, int x1, int y1, int size, int vertOffset, int vertCount) {
+  short verts[VECTOR_FONT_MAX_POLY_SIZE*2];
+  int i, idx=0;
+  for (i=0;i<vertCount;i+=2) {
+    verts[idx+0] = (short)(x1 + (((READ_FLASH_UINT8(&vectorFontPolys[vertOffset+i+0])&0x7F)*size + (VECTOR_FONT_POLY_SIZE/2)) / VECTOR_FONT_POLY_SIZE));
+    verts[idx+1] = (short)(y1 + (((READ_FLASH_UINT8(&vectorFontPolys[vertOffset+i+1])&0x7F)*size + (VECTOR_FONT_POLY_SIZE/2)) / VECTOR_FONT_POLY_SIZE));
+    idx+=2;
+    if (READ_FLASH_UINT8(&vectorFontPolys[vertOffset+i+1]) & VECTOR_FONT_POLY_SEPARATOR) {
+      graphicsFillPoly(gfx,idx/2, verts);
+      if (jspIsInterrupted()) break;
+      idx=0;
+    }
+  }
+}
+
+#ifdef GRAPHICS_GLYPH_CACHE
+/* Glyph cache. Rendered vector characters are stored as 1bpp bitmaps in
+ * DEVICE coordinates in a flat string in the hidden root, and are blitted
+ * with graphicsFillRectDevice. Rendering is translation-invariant, so a
+ * glyph only needs to be keyed on font size, character and the device
+ * orientation flags - the bitmap's position is stored relative to where
+ * the glyph's origin lands in device coordinates. When the cache is full
+ * it is emptied. */
+typedef struct {
+  unsigned short used; ///< bytes used, including this header
+} PACKED_FLAGS GraphicsGlyphCacheHeader;
+
+typedef struct {
+  unsigned short size; ///< font size
+  unsigned char ch; ///< character
+  unsigned char orient; ///< JSGRAPHICSFLAGS_SWAP_XY/INVERT_X/INVERT_Y
+  short offX, offY; ///< bitmap position relative to the glyph origin (device coordinates)
+  unsigned char w, h; ///< bitmap size (device coordinates)
+} PACKED_FLAGS GraphicsGlyphCacheEntry; // followed by the bitmap
+
+#define GRAPHICS_GLYPH_ORIENT_MASK (JSGRAPHICSFLAGS_SWAP_XY|JSGRAPHICSFLAGS_INVERT_X|JSGRAPHICSFLAGS_INVERT_Y)
+
+static unsigned int graphicsGlyphCacheSize = 0; ///< requested size in bytes, 0 = disabled
+static unsigned int graphicsGlyphCacheHits = 0;
+static unsigned int graphicsGlyphCacheMisses = 0;
+
+typedef struct {
+  unsigned char *bits;
+  int width;
+} GraphicsGlyphCapture;
+
+static void graphicsGlyphCaptureSetPixel(JsGraphics *gfx, int x, int y, unsigned int col) {
+  NOT_USED(col);
+  GraphicsGlyphCapture *cap = (GraphicsGlyphCapture*)gfx->backendData;
+  int bit = y*cap->width + x;
+  cap->bits[bit>>3] |= (unsigned char)(1<<(bit&7));
+}
+
+static void graphicsGlyphCaptureFillRect(JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) {
+  int x,y;
+  for (y=y1;y<=y2;y++)
+    for (x=x1;x<=x2;x++)
+      graphicsGlyphCaptureSetPixel(gfx, x, y, col);
+}
+
+void graphicsGlyphCacheSetSize(unsigned int bytes) {
+  graphicsGlyphCacheSize = bytes;
+  graphicsGlyphCacheFree();
+}
+
+bool graphicsGlyphCacheFree() {
+  JsVar *name = jsvFindChildFromString(execInfo.hiddenRoot, GRAPHICS_GLYPH_CACHE_NAME, false);
+  if (!name) return false;
+  jsvRemoveChild(execInfo.hiddenRoot, name);
+  jsvUnLock(name);
+  return true;
+}
+
+void graphicsGlyphCacheGetStats(unsigned int *size, unsigned int *used, unsigned int *hits, unsigned int *misses) {
+  *size = graphicsGlyphCacheSize;
+  *used = 0;
+  JsVar *cache = jsvObjectGetChild(execInfo.hiddenRoot, GRAPHICS_GLYPH_CACHE_NAME, 0);
+  if (cache) *used = ((GraphicsGlyphCacheHeader*)jsvGetFlatStringPointer(cache))->used;
+  jsvUnLock(cache);
+  *hits = graphicsGlyphCacheHits;
+  *misses = graphicsGlyphCacheMisses;
+}
+
+/// Get the glyph cache (creating it if needed and there's enough memory). Returns a locked flat string, or 0
+static JsVar *graphicsGlyphCacheGet() {
+  JsVar *cache = jsvObjectGetChild(execInfo.hiddenRoot, GRAPHICS_GLYPH_CACHE_NAME, 0);
+  if (cache) return cache;
+  // it's only a cache - don't use it if it'd take more than half of the remaining memory
+  unsigned int blocks = (unsigned int)(graphicsGlyphCacheSize / sizeof(JsVar)) + 2;
+  if ((jsvGetMemoryTotal() - jsvGetMemoryUsage()) < blocks*2) return 0;
+  cache = jsvNewFlatStringOfLength(graphicsGlyphCacheSize);
+  if (!cache) return 0;
+  ((GraphicsGlyphCacheHeader*)jsvGetFlatStringPointer(cache))->used = sizeof(GraphicsGlyphCacheHeader);
+  jsvObjectSetChild(execInfo.hiddenRoot, GRAPHICS_GLYPH_CACHE_NAME, cache);
+  return cache;
+}
+
+/** Is the given area entirely inside the clip rect? Polygons that get clipped
+ * can render slightly differently at the clip edge, so partially visible glyphs
+ * aren't drawn from the cache. */
+static bool graphicsGlyphCacheInsideClip(JsGraphics *gfx, int x, int y, int w, int h) {
+  return x >= gfx->data.clipRect.x1 && y >= gfx->data.clipRect.y1 &&
+         x+w-1 <= gfx->data.clipRect.x2 && y+h-1 <= gfx->data.clipRect.y2;
+}
+
+/// Draw a cached glyph bitmap in the foreground color
+static void graphicsGlyphCacheBlit(JsGraphics *gfx, GraphicsGlyphCacheEntry *e, int ox, int oy) {
+  const unsigned char *bits = (const unsigned char *)&e[1];
+  int x, y, bit = 0;
+  ox += e->offX;
+  oy += e->offY;
+  for (y=0;y<e->h;y++) {
+    int runStart = -1;
+    for (x=0;x<=e->w;x++,bit++) {
+      bool set = x<e->w && ((bits[bit>>3]>>(bit&7))&1);
+      if (set && runStart<0) runStart = x;
+      if (!set && runStart>=0) {
+        graphicsFillRectDevice(gfx, ox+runStart, oy+y, ox+x-1, oy+y, gfx->data.fgColor);
+        runStart = -1;
+      }
+    }
+    bit--; // x went to w (inclusive) for the end of the run
+  }
+}
+
+/** Draw a vector character using the glyph cache, rendering and adding it
+ * if it's not there. Returns false if it couldn't be cached (so should be drawn normally) */
+static bool graphicsGlyphCacheDrawVectorChar(JsGraphics *gfx, int x1, int y1, int size, char ch, int vertOffset, int vertCount) {
+  int ox = x1, oy = y1;
+  graphicsToDeviceCoordinates(gfx, &ox, &oy);
+  unsigned char orient = (unsigned char)(gfx->data.flags & GRAPHICS_GLYPH_ORIENT_MASK);
+  JsVar *cache = graphicsGlyphCacheGet();
+  if (!cache) return false;
+  size_t cacheLen = jsvGetStringLength(cache);
+  unsigned char *data = (unsigned char*)jsvGetFlatStringPointer(cache);
+  GraphicsGlyphCacheHeader *hdr = (GraphicsGlyphCacheHeader*)data;
+  // look for the glyph
+  size_t pos = sizeof(GraphicsGlyphCacheHeader);
+  while (pos < hdr->used) {
+    GraphicsGlyphCacheEntry *e = (GraphicsGlyphCacheEntry*)&data[pos];
+    if (e->size==size && e->ch==(unsigned char)ch && e->orient==orient) {
+      if (!graphicsGlyphCacheInsideClip(gfx, ox+e->offX, oy+e->offY, e->w, e->h)) {
+        jsvUnLock(cache);
+        return false;
+      }
+      graphicsGlyphCacheHits++;
+      graphicsGlyphCacheBlit(gfx, e, ox, oy);
+      jsvUnLock(cache);
+      return true;
+    }
+    pos += (sizeof(GraphicsGlyphCacheEntry) + (size_t)((e->w*e->h+7)>>3) + 1) & ~(size_t)1;
+  }
+  // not found - work out the glyph's bounds in device coordinates
+  int i, minx=0x7FFF, miny=0x7FFF, maxx=-0x7FFF, maxy=-0x7FFF;
+  for (i=0;i<vertCount;i+=2) {
+    int vx = x1 + (((READ_FLASH_UINT8(&vectorFontPolys[vertOffset+i+0])&0x7F)*size + (VECTOR_FONT_POLY_SIZE/2)) / VECTOR_FONT_POLY_SIZE);
+    int vy = y1 + (((READ_FLASH_UINT8(&vectorFontPolys[vertOffset+i+1])&0x7F)*size + (VECTOR_FONT_POLY_SIZE/2)) / VECTOR_FONT_POLY_SIZE);
+    graphicsToDeviceCoordinates(gfx, &vx, &vy);
+    if (vx<minx) minx=vx;
+    if (vx>maxx) maxx=vx;
+    if (vy<miny) miny=vy;
+    if (vy>maxy) maxy=vy;
+  }
+  int w = maxx+1-minx, h = maxy+1-miny;
+  size_t entryLen = (sizeof(GraphicsGlyphCacheEntry) + (size_t)((w*h+7)>>3) + 1) & ~(size_t)1;
+  if (vertCount<2 || w>255 || h>255 || entryLen+sizeof(GraphicsGlyphCacheHeader) > cacheLen ||
+      !graphicsGlyphCacheInsideClip(gfx, minx, miny, w, h)) {
+    jsvUnLock(cache);
+    return false;
+  }
+  graphicsGlyphCacheMisses++;
+  if (hdr->used + entryLen > cacheLen)
+    hdr->used = sizeof(GraphicsGlyphCacheHeader); // full - empty it
+  GraphicsGlyphCacheEntry *e = (GraphicsGlyphCacheEntry*)&data[hdr->used];
+  e->size = (unsigned short)size;
+  e->ch = (unsigned char)ch;
+  e->orient = orient;
+  e->offX = (short)(minx-ox);
+  e->offY = (short)(miny-oy);
+  e->w = (unsigned char)w;
+  e->h = (unsigned char)h;
+  memset(&e[1], 0, entryLen-sizeof(GraphicsGlyphCacheEntry));
+  /* Render the glyph so its bounds start at device coordinate 0,0, using a
+   * copy of gfx that writes into the bitmap. To move it by -minx,-miny in
+   * device coordinates we have to work out the equivalent user coordinates. */
+  int dx = -minx, dy = -miny;
+  if (orient & JSGRAPHICSFLAGS_INVERT_X) dx = -dx;
+  if (orient & JSGRAPHICSFLAGS_INVERT_Y) dy = -dy;
+  if (orient & JSGRAPHICSFLAGS_SWAP_XY) {
+    int t = dx;
+    dx = dy;
+    dy = t;
+  }
+  GraphicsGlyphCapture capture;
+  capture.bits = (unsigned char*)&e[1];
+  capture.width = w;
+  JsGraphics capGfx = *gfx;
+  capGfx.backendData = &capture;
+  capGfx.setPixel = graphicsGlyphCaptureSetPixel;
+  capGfx.fillRect = graphicsGlyphCaptureFillRect;
+  capGfx.data.clipRect.x1 = 0;
+  capGfx.data.clipRect.y1 = 0;
+  capGfx.data.clipRect.x2 = (unsigned short)(w-1);
+  capGfx.data.clipRect.y2 = (unsigned short)(h-1);
+  graphicsFillVectorCharPolys(&capGfx, x1+dx, y1+dy, size, vertOffset, vertCount);
+  hdr->used = (unsigned short)(hdr->used + entryLen);
+  graphicsGlyphCacheBlit(gfx, e, ox, oy);
+  jsvUnLock(cache);
+  return true;
+}
+#endif
+
 // prints character, returns width
 unsigned int graphicsFillVectorChar(JsGraphics *gfx, int x1, int y1, int size, char ch) {
   // no need to modify coordinates as graphicsFillPoly does that
@@ -500,18 +1054,11 @@ unsigned int graphicsFillVectorChar(JsGraphics *gfx, int x1, int y1, int size, c
   VectorFontChar vector;
   vector.vertCount = READ_FLASH_UINT8(&vectorFonts[fontOffset].vertCount);
   vector.width = READ_FLASH_UINT8(&vectorFonts[fontOffset].width);
-  short verts[VECTOR_FONT_MAX_POLY_SIZE*2];
-  int idx=0;
-  for (i=0;i<vector.vertCount;i+=2) {
-    verts[idx+0] = (short)(x1 + (((READ_FLASH_UINT8(&vectorFontPolys[vertOffset+i+0])&0x7F)*size + (VECTOR_FONT_POLY_SIZE/2)) / VECTOR_FONT_POLY_SIZE));
-    verts[idx+1] = (short)(y1 + (((READ_FLASH_UINT8(&vectorFontPolys[vertOffset+i+1])&0x7F)*size + (VECTOR_FONT_POLY_SIZE/2)) / VECTOR_FONT_POLY_SIZE));
-    idx+=2;
-    if (READ_FLASH_UINT8(&vectorFontPolys[vertOffset+i+1]) & VECTOR_FONT_POLY_SEPARATOR) {
-      graphicsFillPoly(gfx,idx/2, verts);
-      if (jspIsInterrupted()) break;
-      idx=0;
-    }
-  }
+#ifdef GRAPHICS_GLYPH_CACHE
+  if (!graphicsGlyphCacheSize ||
+      !graphicsGlyphCacheDrawVectorChar(gfx, x1, y1, size, ch, vertOffset, vector.vertCount))
+#endif
+    graphicsFillVectorCharPolys(gfx, x1, y1, size, vertOffset, vector.vertCount);
   return (vector.width * (unsigned int)size)/(VECTOR_FONT_POLY_SIZE*2);
 }
 
@@ -28,7 +28,8 @@ typedef enum {
   JSGRAPHICSTYPE_FSMC,        ///< FSMC (or fake FSMC) ILI9325 16bit-wide LCDs
   JSGRAPHICSTYPE_SDL,         ///< SDL graphics library for linux
   JSGRAPHICSTYPE_SPILCD,      ///< SPI LCD library
-  JSGRAPHICSTYPE_ST7789_8BIT  ///< ST7789 in 8 bit mode
+  JSGRAPHICSTYPE_ST7789_8BIT, ///< ST7789 in 8 bit mode
+  JSGRAPHICSTYPE_LINUXFB      ///< Linux framebuffer device (/dev/fbX)
 } JsGraphicsType;
 
 typedef enum {
@@ -73,6 +74,18 @@ typedef struct {
   unsigned short x2,y2;
 } PACKED_FLAGS JsGraphicsClipRect;
 
+#ifndef SAVE_ON_FLASH
+/// Max number of separate modified regions we track before merging them
+#define GRAPHICS_MOD_RECTS 4
+/// Merge two modified regions if their union wastes fewer than this many pixels (plus 25%)
+#define GRAPHICS_MOD_MERGE_SLACK 64
+
+typedef struct {
+  short x1,y1;
+  short x2,y2;
+} PACKED_FLAGS JsGraphicsModRect;
+#endif
+
 typedef struct {
   JsGraphicsType type;
   JsGraphicsFlags flags;
@@ -89,9 +102,22 @@ typedef struct {
 #ifndef SAVE_ON_FLASH
   JsGraphicsClipRect clipRect;
   short modMinX, modMinY, modMaxX, modMaxY; ///< area that has been modified
+  unsigned char modRectCount; ///< how many entries in modRects are used
+  JsGraphicsModRect modRects[GRAPHICS_MOD_RECTS]; ///< separate modified regions (all inside modMin/Max), for partial flips
+  unsigned int flipCount, flipBytes; ///< how many times we've flipped, and how many bytes were sent to the display
 #endif
 } PACKED_FLAGS JsGraphicsData;
 
+/// A row of image pixels, for JsGraphics.blitRow
+typedef struct {
+  const unsigned char *data; ///< image pixels, packed MSB first
+  unsigned int bitOffset; ///< bit index in data of the first pixel to draw
+  unsigned int bpp; ///< bits per pixel in the image
+  const uint16_t *palette; ///< if set, pixel values are looked up in here
+  unsigned int paletteMask; ///< pixel values are ANDed with this before palette lookup
+  unsigned int transparentCol; ///< pixels with this (pre-palette) value aren't drawn. 0xFFFFFFFF = none
+} JsGraphicsBlitSource;
+
 typedef struct JsGraphics {
   JsVar *graphicsVar; // this won't be locked again - we just know that it is already locked by something else
   JsGraphicsData data;
@@ -102,6 +128,7 @@ typedef struct JsGraphics {
   void (*fillRect)(struct JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col);
   unsigned int (*getPixel)(struct JsGraphics *gfx, int x, int y);
   void (*scroll)(struct JsGraphics *gfx, int xdir, int ydir); // scroll - leave unscrolled area undefined
+  void (*blitRow)(struct JsGraphics *gfx, int x, int y, int count, const JsGraphicsBlitSource *src); ///< optional - draw 'count' image pixels at x,y (DEVICE coords, already clipped). 0 if not supported
 } PACKED_FLAGS JsGraphics;
 
 // ---------------------------------- these are in graphics.c
@@ -113,6 +140,12 @@ void graphicsStructInit(JsGraphics *gfx, int width, int height, int bpp);
 bool graphicsGetFromVar(JsGraphics *gfx, JsVar *parent);
 /// Access the Graphics Instance JsVar and set the relevant info from JsGraphics structure
 void graphicsSetVar(JsGraphics *gfx);
+#ifndef SAVE_ON_FLASH
+/// Mark an area (in DEVICE coordinates, already clipped) as modified
+void graphicsSetModified(JsGraphics *gfx, int x1, int y1, int x2, int y2);
+/// Clear the modified area (eg. after a flip)
+void graphicsResetModified(JsGraphics *gfx);
+#endif
 // ----------------------------------------------------------------------------------------------
 /// Get the memory requires for this graphics's pixels if everything was packed as densely as possible
 size_t graphicsGetMemoryRequired(const JsGraphics *gfx);
@@ -129,7 +162,21 @@ void graphicsDrawEllipse(JsGraphics *gfx, int x, int y, int x2, int y2);
 void graphicsFillEllipse(JsGraphics *gfx, int x, int y, int x2, int y2);
 void graphicsDrawLine(JsGraphics *gfx, int x1, int y1, int x2, int y2);
 void graphicsFillPoly(JsGraphics *gfx, int points, short *vertices); // may overwrite vertices...
+#if !defined(SAVE_ON_FLASH) && !defined(ESPRUINOBOARD)
+#define GRAPHICS_ANTIALIAS
+unsigned int graphicsBlendColor(JsGraphics *gfx, unsigned int a, unsigned int b, int amt); ///< blend from colour a to b by amt (0..256)
+void graphicsDrawLineAA(JsGraphics *gfx, double x1, double y1, double x2, double y2); ///< Wu's anti-aliased line (aliased below 4bpp)
+void graphicsDrawCircleAA(JsGraphics *gfx, double x, double y, double r); ///< anti-aliased 1px circle (aliased below 4bpp)
+void graphicsDrawBezier(JsGraphics *gfx, int points, const double *xy, bool antialias); ///< quadratic (3 points) or cubic (4 points) bezier
+#endif
 #ifndef NO_VECTOR_FONT
+#ifndef SAVE_ON_FLASH
+#define GRAPHICS_GLYPH_CACHE
+#define GRAPHICS_GLYPH_CACHE_NAME JS_HIDDEN_CHAR_STR"GlyphC"
+void graphicsGlyphCacheSetSize(unsigned int bytes); ///< Set the size of the vector font glyph cache (0=disabled). Flushes the cache
+bool graphicsGlyphCacheFree(); ///< Free the glyph cache's memory (it'll be recreated when needed). True if anything was freed
+void graphicsGlyphCacheGetStats(unsigned int *size, unsigned int *used, unsigned int *hits, unsigned int *misses);
+#endif
 unsigned int graphicsFillVectorChar(JsGraphics *gfx, int x1, int y1, int size, char ch); ///< prints character, returns width
 unsigned int graphicsVectorCharWidth(JsGraphics *gfx, unsigned int size, char ch); ///< returns the width of a character
 #endif
@@ -25,8 +25,15 @@
 #ifdef USE_LCD_FSMC
 #include "lcd_fsmc.h"
 #endif
+#ifdef USE_LCD_LINUX
+#include "lcd_linux.h"
+#endif
 
 #include "jswrap_functions.h" // for asURL
+#include "jswrapper.h" // for JSWAT_*
+#ifdef USE_HEATSHRINK
+#include "compress_heatshrink.h"
+#endif
 
 #include "bitmap_font_4x6.h"
 #include "bitmap_font_6x8.h"
@@ -84,9 +91,24 @@ Use Graphics.createXXX to create a graphics object that renders in the way you w
 }*/
 bool jswrap_graphics_idle() {
   graphicsIdle();
+#ifndef SAVE_ON_FLASH
+  return lcdIdle_ArrayBuffer();
+#else
   return false;
+#endif
 }
 
+#ifndef SAVE_ON_FLASH
+/*JSON{
+  "type" : "kill",
+  "generate" : "jswrap_graphics_kill",
+  "ifndef" : "SAVE_ON_FLASH"
+}*/
+void jswrap_graphics_kill() {
+  lcdKill_ArrayBuffer();
+}
+#endif
+
 /*JSON{
   "type" : "init",
   "generate" : "jswrap_graphics_init"
@@ -146,13 +168,28 @@ static bool isValidBPP(int bpp) {
       "vertical_byte = whether to align bits in a byte vertically or not",
       "msb = when bits<8, store pixels msb first",
       "interleavex = Pixels 0,2,4,etc are from the top half of the image, 1,3,5,etc from the bottom half. Used for P3 LED panels.",
-      "color_order = re-orders the colour values that are supplied via setColor"
+      "color_order = re-orders the colour values that are supplied via setColor",
+      "doubleBuffer = draw into a second buffer, which `g.flip()` swaps with the first (see below)",
+      "output = (Linux only) a file or device that `g.flip()` writes each frame to in the background"
     ]]
   ],
   "return" : ["JsVar","The new Graphics object"],
   "return_object" : "Graphics"
 }
 Create a Graphics object that renders to an Array Buffer. This will have a field called 'buffer' that can get used to get at the buffer itself
+
+If `doubleBuffer` is set, a second buffer is allocated and the Graphics gets a `flip()` method.
+`g.flip()` swaps the buffers, so `g.buffer` then refers to the buffer you'll draw the next frame in
+(it starts off with a copy of the last frame). On Linux, if `output` is also set, the areas of the last
+frame that were modified are written to that file in a worker thread, so the next frame can be drawn
+while they're sent. `g.flip()` returns a Promise that resolves when the frame has been sent, and
+calling it again before then waits for the previous frame.
+
+```
+var g = Graphics.createArrayBuffer(320,240,16,{doubleBuffer:true, output:"/tmp/frame.raw"});
+g.fillRect(10,10,50,50);
+g.flip().then(() => print("Sent!"));
+```
 */
 JsVar *jswrap_graphics_createArrayBuffer(int width, int height, int bpp, JsVar *options) {
   if (width<=0 || height<=0 || width>32767 || height>32767) {
@@ -212,6 +249,17 @@ JsVar *jswrap_graphics_createArrayBuffer(int width, int height, int bpp, JsVar *
   }
 
   lcdInit_ArrayBuffer(&gfx);
+#ifndef SAVE_ON_FLASH
+  if (jsvIsObject(options) && jsvGetBoolAndUnLock(jsvObjectGetChild(options, "doubleBuffer", 0))) {
+    JsVar *output = jsvObjectGetChild(options, "output", 0);
+    bool ok = lcdInitDoubleBuffer_ArrayBuffer(&gfx, output);
+    jsvUnLock(output);
+    if (!ok) {
+      jsvUnLock(parent);
+      return 0;
+    }
+  }
+#endif
   graphicsSetVar(&gfx);
   return parent;
 }
@@ -309,6 +357,77 @@ JsVar *jswrap_graphics_createSDL(int width, int height, int bpp) {
 }
 #endif
 
+#ifdef USE_LCD_LINUX
+/// g.flip() for framebuffers
+static void jswrap_graphics_flipFramebuffer(JsVar *parent) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return;
+  lcdFlipFramebuffer_Linux(&gfx);
+  graphicsSetVar(&gfx);
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "Graphics",
+  "name" : "createFramebuffer",
+  "ifdef" : "USE_LCD_LINUX",
+  "generate" : "jswrap_graphics_createFramebuffer",
+  "params" : [
+    ["path","JsVar","The framebuffer device, eg `/dev/fb0`"],
+    ["options","JsVar","An object of other options. ```{ doubleBuffer : true/false(default), width, height, bpp }``` - `width`, `height` and `bpp` are only used if `path` is a plain file rather than a framebuffer device"]
+  ],
+  "return" : ["JsVar","The new Graphics object"],
+  "return_object" : "Graphics"
+}
+Create a Graphics object that renders straight into a Linux framebuffer device (Linux-based devices only).
+
+The framebuffer is memory mapped, so drawing is as fast as for a flat ArrayBuffer. If `doubleBuffer` is set,
+drawing happens in an offscreen page and `g.flip()` pans the display to show it (without waiting for vsync),
+then copies the modified areas across so the other page can be drawn into next.
+
+If `path` is a plain file, it is used as a fake framebuffer (with both pages one after the other if double buffered),
+which is handy for testing:
+
+```
+var g = Graphics.createFramebuffer("/tmp/fb.raw", {width:320, height:240, bpp:16, doubleBuffer:true});
+```
+*/
+JsVar *jswrap_graphics_createFramebuffer(JsVar *path, JsVar *options) {
+  char pathStr[256];
+  if (!jsvIsString(path) || jsvGetString(path, pathStr, sizeof(pathStr)) >= sizeof(pathStr)-1) {
+    jsExceptionHere(JSET_ERROR, "Expecting a path as a String, got %t", path);
+    return 0;
+  }
+  int width = 0, height = 0, bpp = 0;
+  bool doubleBuffer = false;
+  if (jsvIsObject(options)) {
+    width = jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "width", 0));
+    height = jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "height", 0));
+    bpp = jsvGetIntegerAndUnLock(jsvObjectGetChild(options, "bpp", 0));
+    doubleBuffer = jsvGetBoolAndUnLock(jsvObjectGetChild(options, "doubleBuffer", 0));
+  }
+  if (bpp && !isValidBPP(bpp)) {
+    jsExceptionHere(JSET_ERROR, "Invalid BPP");
+    return 0;
+  }
+  if (!lcdInitFramebuffer_Linux(pathStr, &width, &height, &bpp, doubleBuffer))
+    return 0;
+  if (width<=0 || height<=0 || width>32767 || height>32767 || !isValidBPP(bpp)) {
+    jsExceptionHere(JSET_ERROR, "Unsupported framebuffer size or bpp");
+    return 0;
+  }
+
+  JsVar *parent = jspNewObject(0, "Graphics");
+  if (!parent) return 0; // low memory
+  JsGraphics gfx;
+  graphicsStructInit(&gfx,width,height,bpp);
+  gfx.data.type = JSGRAPHICSTYPE_LINUXFB;
+  gfx.graphicsVar = parent;
+  graphicsSetVar(&gfx);
+  jsvObjectSetChildAndUnLock(parent, "flip", jsvNewNativeFunction((void (*)(void))jswrap_graphics_flipFramebuffer, JSWAT_VOID|JSWAT_THIS_ARG));
+  return parent;
+}
+#endif
+
 
 /*JSON{
   "type" : "staticmethod",
@@ -559,8 +678,7 @@ JsVar *jswrap_graphics_drawRect(JsVar *parent, int x1, int y1, int x2, int y2) {
 Draw a filled circle in the Foreground Color
 */
  JsVar *jswrap_graphics_fillCircle(JsVar *parent, int x, int y, int rad) {
-   jswrap_graphics_fillEllipse(parent, x-rad, y-rad, x+rad, y+rad);
-   return jsvLockAgain(parent);
+   return jswrap_graphics_fillEllipse(parent, x-rad, y-rad, x+rad, y+rad);
  }
 
 /*JSON{
@@ -580,7 +698,31 @@ Draw a filled circle in the Foreground Color
 Draw an unfilled circle 1px wide in the Foreground Color
 */
 JsVar *jswrap_graphics_drawCircle(JsVar *parent, int x, int y, int rad) {
-  jswrap_graphics_drawEllipse(parent, x-rad, y-rad, x+rad, y+rad);
+  return jswrap_graphics_drawEllipse(parent, x-rad, y-rad, x+rad, y+rad);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "drawCircleAA",
+  "#if" : "!defined(SAVE_ON_FLASH) && !defined(ESPRUINOBOARD)",
+  "generate" : "jswrap_graphics_drawCircleAA",
+  "params" : [
+    ["x","float","The X axis"],
+    ["y","float","The Y axis"],
+    ["rad","float","The circle radius"]
+  ],
+  "return" : ["JsVar","The instance of Graphics this was called on, to allow call chaining"],
+  "return_object" : "Graphics"
+}
+Draw an anti-aliased, unfilled circle 1px wide in the Foreground Color. The position and radius can be fractional.
+
+As with `drawLineAA` this needs at least 4 bits per pixel.
+*/
+JsVar *jswrap_graphics_drawCircleAA(JsVar *parent, double x, double y, double rad) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  graphicsDrawCircleAA(&gfx, x, y, rad);
+  graphicsSetVar(&gfx); // gfx data changed because modified area
   return jsvLockAgain(parent);
 }
 
@@ -1283,6 +1425,25 @@ JsVar *jswrap_graphics_drawString(JsVar *parent, JsVar *var, int x, int y, bool
     customWidth = jsvObjectGetChild(parent, JSGRAPHICS_CUSTOMFONT_WIDTH, 0);
     customFirstChar = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(parent, JSGRAPHICS_CUSTOMFONT_FIRSTCHAR, 0));
   }
+  /* For variable width custom fonts, work out the offset of each character in
+   * the bitmap up front rather than summing the widths for every character drawn */
+  int customWidthCount = 0;
+  if (jsvIsString(customWidth)) {
+    customWidthCount = (int)jsvGetStringLength(customWidth);
+    if (customWidthCount>256) customWidthCount = 256;
+  }
+  unsigned short customOffsets[customWidthCount+1];
+  customOffsets[0] = 0;
+  if (customWidthCount) {
+    JsvStringIterator wit;
+    jsvStringIteratorNew(&wit, customWidth, 0);
+    int i;
+    for (i=0;i<customWidthCount;i++) {
+      customOffsets[i+1] = (unsigned short)(customOffsets[i] + (unsigned char)jsvStringIteratorGetChar(&wit));
+      jsvStringIteratorNext(&wit);
+    }
+    jsvStringIteratorFree(&wit);
+  }
 #ifndef SAVE_ON_FLASH
   // Handle text rotation
   JsGraphicsFlags oldFlags = gfx.data.flags;
@@ -1351,14 +1512,12 @@ JsVar *jswrap_graphics_drawString(JsVar *parent, JsVar *var, int x, int y, bool
       int width = 0, bmpOffset = 0;
       if (jsvIsString(customWidth)) {
         if (ch>=customFirstChar) {
-          JsvStringIterator wit;
-          jsvStringIteratorNew(&wit, customWidth, 0);
-          while (jsvStringIteratorHasChar(&wit) && (int)jsvStringIteratorGetIndex(&wit)<(ch-customFirstChar)) {
-            bmpOffset += (unsigned char)jsvStringIteratorGetChar(&wit);
-            jsvStringIteratorNext(&wit);
-          }
-          width = (unsigned char)jsvStringIteratorGetChar(&wit);
-          jsvStringIteratorFree(&wit);
+          int idx = ch-customFirstChar;
+          if (idx<customWidthCount) {
+            bmpOffset = customOffsets[idx];
+            width = customOffsets[idx+1] - customOffsets[idx];
+          } else
+            bmpOffset = customOffsets[customWidthCount];
         }
       } else {
         width = (int)jsvGetInteger(customWidth);
@@ -1405,6 +1564,53 @@ JsVar *jswrap_graphics_drawString(JsVar *parent, JsVar *var, int x, int y, bool
   return jsvLockAgain(parent);
 }
 
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "Graphics",
+  "name" : "setGlyphCacheSize",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_setGlyphCacheSize",
+  "params" : [
+    ["size","int","The amount of memory (in bytes) to use for the cache, or 0 to disable it"]
+  ]
+}
+Vector font characters drawn with `drawString` can be cached as bitmaps,
+which makes redrawing the same text much faster. This sets the size of the cache
+(it is disabled by default) and empties it.
+
+The cache is stored in variable memory, and is freed automatically if Espruino runs
+low on memory.
+*/
+void jswrap_graphics_setGlyphCacheSize(int size) {
+#ifdef GRAPHICS_GLYPH_CACHE
+  graphicsGlyphCacheSetSize((unsigned int)((size>0) ? (size>65535 ? 65535 : size) : 0));
+#endif
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "class" : "Graphics",
+  "name" : "getGlyphCacheStats",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_getGlyphCacheStats",
+  "return" : ["JsVar","An object containing `size`, `used` (both in bytes), `hits` and `misses`"]
+}
+Get information about the glyph cache - see `Graphics.setGlyphCacheSize`
+*/
+JsVar *jswrap_graphics_getGlyphCacheStats() {
+  JsVar *o = jsvNewObject();
+  if (!o) return 0;
+#ifdef GRAPHICS_GLYPH_CACHE
+  unsigned int size, used, hits, misses;
+  graphicsGlyphCacheGetStats(&size, &used, &hits, &misses);
+  jsvObjectSetChildAndUnLock(o, "size", jsvNewFromInteger((JsVarInt)size));
+  jsvObjectSetChildAndUnLock(o, "used", jsvNewFromInteger((JsVarInt)used));
+  jsvObjectSetChildAndUnLock(o, "hits", jsvNewFromInteger((JsVarInt)hits));
+  jsvObjectSetChildAndUnLock(o, "misses", jsvNewFromInteger((JsVarInt)misses));
+#endif
+  return o;
+}
+
 /// Convenience function for using drawString from C code
 void jswrap_graphics_drawCString(JsGraphics *gfx, int x, int y, char *str) {
   JsVar *s = jsvNewFromString(str);
@@ -1493,6 +1699,35 @@ JsVar *jswrap_graphics_drawLine(JsVar *parent, int x1, int y1, int x2, int y2) {
   return jsvLockAgain(parent);
 }
 
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "drawLineAA",
+  "#if" : "!defined(SAVE_ON_FLASH) && !defined(ESPRUINOBOARD)",
+  "generate" : "jswrap_graphics_drawLineAA",
+  "params" : [
+    ["x1","float","The left"],
+    ["y1","float","The top"],
+    ["x2","float","The right"],
+    ["y2","float","The bottom"]
+  ],
+  "return" : ["JsVar","The instance of Graphics this was called on, to allow call chaining"],
+  "return_object" : "Graphics"
+}
+Draw an anti-aliased line between x1,y1 and x2,y2 in the current foreground color.
+Coordinates can be fractional.
+
+The line is blended with what's already on the screen, so this needs a Graphics with at
+least 4 bits per pixel (below that a normal line is drawn). With 4 and 8 bits per pixel,
+colours are assumed to be shades of grey.
+*/
+JsVar *jswrap_graphics_drawLineAA(JsVar *parent, double x1, double y1, double x2, double y2) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  graphicsDrawLineAA(&gfx, x1,y1,x2,y2);
+  graphicsSetVar(&gfx); // gfx data changed because modified area
+  return jsvLockAgain(parent);
+}
+
 /*JSON{
   "type" : "method",
   "class" : "Graphics",
@@ -1553,9 +1788,7 @@ JsVar *jswrap_graphics_moveTo(JsVar *parent, int x, int y) {
 }
 Draw a polyline (lines between each of the points in `poly`) in the current foreground color
 */
-JsVar *jswrap_graphics_drawPoly(JsVar *parent, JsVar *poly, bool closed) {
-  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
-  if (!jsvIsIterable(poly)) return 0;
+static void jswrap_graphics_drawPolyGfx(JsGraphics *gfx, JsVar *poly, bool closed) {
   int x,y;
   int startx, starty;
   int idx = 0;
@@ -1570,10 +1803,10 @@ JsVar *jswrap_graphics_drawPoly(JsVar *parent, JsVar *poly, bool closed) {
         starty = y;
       } else {
         // only start drawing between the first 2 points
-        graphicsDrawLine(&gfx, gfx.data.cursorX, gfx.data.cursorY, x, y);
+        graphicsDrawLine(gfx, gfx->data.cursorX, gfx->data.cursorY, x, y);
       }
-      gfx.data.cursorX = (short)x;
-      gfx.data.cursorY = (short)y;
+      gfx->data.cursorX = (short)x;
+      gfx->data.cursorY = (short)y;
     } else x = el;
     idx++;
     jsvIteratorNext(&it);
@@ -1581,8 +1814,13 @@ JsVar *jswrap_graphics_drawPoly(JsVar *parent, JsVar *poly, bool closed) {
   jsvIteratorFree(&it);
   // if closed, draw between first and last points
   if (closed)
-    graphicsDrawLine(&gfx, gfx.data.cursorX, gfx.data.cursorY, startx, starty);
+    graphicsDrawLine(gfx, gfx->data.cursorX, gfx->data.cursorY, startx, starty);
+}
 
+JsVar *jswrap_graphics_drawPoly(JsVar *parent, JsVar *poly, bool closed) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  if (!jsvIsIterable(poly)) return 0;
+  jswrap_graphics_drawPolyGfx(&gfx, poly, closed);
   graphicsSetVar(&gfx); // gfx data changed because modified area
   return jsvLockAgain(parent);
 }
@@ -1601,10 +1839,13 @@ JsVar *jswrap_graphics_drawPoly(JsVar *parent, JsVar *poly, bool closed) {
 }
 Draw a filled polygon in the current foreground color
 */
-JsVar *jswrap_graphics_fillPoly(JsVar *parent, JsVar *poly) {
-  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
-  if (!jsvIsIterable(poly)) return 0;
-  const int maxVerts = 128;
+static void jswrap_graphics_fillPolyGfx(JsGraphics *gfx, JsVar *poly) {
+  /* Vertices (and graphicsFillPoly's edge list) are stored on the stack,
+   * which needs around 64 bytes per point */
+  int maxVerts = (int)jsvGetLength(poly);
+  int stackVerts = (int)(jsuGetFreeStack() / 64) & ~1;
+  if (maxVerts > stackVerts) maxVerts = stackVerts;
+  if (maxVerts < 2) return;
   short verts[maxVerts];
   int idx = 0;
   JsvIterator it;
@@ -1614,11 +1855,168 @@ JsVar *jswrap_graphics_fillPoly(JsVar *parent, JsVar *poly) {
     jsvIteratorNext(&it);
   }
   jsvIteratorFree(&it);
-  if (idx==maxVerts) {
+  if (idx==maxVerts && maxVerts==stackVerts) {
     jsWarn("Maximum number of points (%d) exceeded for fillPoly", maxVerts/2);
   }
-  graphicsFillPoly(&gfx, idx/2, verts);
+  graphicsFillPoly(gfx, idx/2, verts);
+}
+
+JsVar *jswrap_graphics_fillPoly(JsVar *parent, JsVar *poly) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  if (!jsvIsIterable(poly)) return 0;
+  jswrap_graphics_fillPolyGfx(&gfx, poly);
+  graphicsSetVar(&gfx); // gfx data changed because modified area
+  return jsvLockAgain(parent);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "draw",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_draw",
+  "params" : [
+    ["commands","JsVar","An array of drawing commands, each of the form `[\"name\", arg1, arg2, ...]`"]
+  ],
+  "return" : ["JsVar","The instance of Graphics this was called on, to allow call chaining"],
+  "return_object" : "Graphics"
+}
+Execute a list of drawing commands in one go. This is much faster than calling
+the individual drawing functions when drawing lots of small items (eg. points on a chart),
+as the Graphics instance's state only has to be read and written once.
+
+```
+g.draw([
+  ["color", 0xF800],
+  ["moveTo", 0, 50], ["lineTo", 10, 40], ["lineTo", 20, 45],
+  ["fillRect", 30, 30, 40, 40],
+  ["pixel", 5, 5]
+]);
+```
+
+Supported commands (with arguments as for the Graphics method of the same purpose) are:
+
+* `["pixel", x, y, col]` - `setPixel` (`col` is optional)
+* `["line", x1, y1, x2, y2]` - `drawLine`
+* `["moveTo", x, y]`, `["lineTo", x, y]`
+* `["rect", x1, y1, x2, y2]`, `["fillRect", x1, y1, x2, y2]`, `["clearRect", x1, y1, x2, y2]`
+* `["ellipse", x1, y1, x2, y2]`, `["fillEllipse", x1, y1, x2, y2]`
+* `["circle", x, y, rad]`, `["fillCircle", x, y, rad]`
+* `["poly", [x1,y1,x2,y2,...], closed]`, `["fillPoly", [x1,y1,x2,y2,...]]`
+* `["color", col]`, `["bgColor", col]` - as for `setColor`/`setBgColor` with one argument
+*/
+typedef enum {
+  GDC_PIXEL, GDC_LINE, GDC_MOVETO, GDC_LINETO,
+  GDC_RECT, GDC_FILLRECT, GDC_CLEARRECT,
+  GDC_ELLIPSE, GDC_FILLELLIPSE, GDC_CIRCLE, GDC_FILLCIRCLE,
+  GDC_POLY, GDC_FILLPOLY, GDC_COLOR, GDC_BGCOLOR,
+  GDC_COUNT
+} GraphicsDrawCommand;
+static const char *graphicsDrawCommandNames[GDC_COUNT] = {
+  "pixel", "line", "moveTo", "lineTo",
+  "rect", "fillRect", "clearRect",
+  "ellipse", "fillEllipse", "circle", "fillCircle",
+  "poly", "fillPoly", "color", "bgColor"
+};
+
+/// Execute a single draw command (an array). Returns false (with an exception) on error
+static bool jswrap_graphics_drawCommand(JsVar *parent, JsGraphics *gfx, JsVar *cmd) {
+  if (!jsvIsArray(cmd)) {
+    jsExceptionHere(JSET_TYPEERROR, "Expecting each draw command to be an Array, got %t", cmd);
+    return false;
+  }
+  // Read the command name, the first argument as a JsVar, and up to 4 integer arguments
+  char name[16];
+  name[0] = 0;
+  JsVar *firstArg = 0, *colArg = 0;
+  int argCount = 0;
+  int a[4] = {0,0,0,0};
+  bool closed = false;
+  JsvIterator it;
+  jsvIteratorNew(&it, cmd, JSIF_EVERY_ARRAY_ELEMENT);
+  while (jsvIteratorHasElement(&it)) {
+    JsVar *v = jsvIteratorGetValue(&it);
+    if (argCount==0) {
+      if (jsvIsString(v)) jsvGetString(v, name, sizeof(name));
+    } else {
+      if (argCount==1) firstArg = jsvLockAgain(v);
+      if (argCount<=4) a[argCount-1] = (int)jsvGetInteger(v);
+      if (argCount==2) closed = jsvGetBool(v);
+      if (argCount==3) colArg = jsvLockAgain(v);
+    }
+    jsvUnLock(v);
+    argCount++;
+    jsvIteratorNext(&it);
+  }
+  jsvIteratorFree(&it);
 
+  int c;
+  for (c=0;c<GDC_COUNT;c++)
+    if (!strcmp(name, graphicsDrawCommandNames[c])) break;
+  switch ((GraphicsDrawCommand)c) {
+    case GDC_PIXEL: {
+      unsigned int col = gfx->data.fgColor;
+      if (colArg && !jsvIsUndefined(colArg)) col = jswrap_graphics_toColor(parent, colArg, 0, 0);
+      graphicsSetPixel(gfx, a[0], a[1], col);
+      gfx->data.cursorX = (short)a[0];
+      gfx->data.cursorY = (short)a[1];
+      break;
+    }
+    case GDC_LINE: graphicsDrawLine(gfx, a[0], a[1], a[2], a[3]); break;
+    case GDC_LINETO: graphicsDrawLine(gfx, gfx->data.cursorX, gfx->data.cursorY, a[0], a[1]); // fall through
+    case GDC_MOVETO:
+      gfx->data.cursorX = (short)a[0];
+      gfx->data.cursorY = (short)a[1];
+      break;
+    case GDC_RECT: graphicsDrawRect(gfx, a[0], a[1], a[2], a[3]); break;
+    case GDC_FILLRECT: graphicsFillRect(gfx, a[0], a[1], a[2], a[3], gfx->data.fgColor); break;
+    case GDC_CLEARRECT: graphicsFillRect(gfx, a[0], a[1], a[2], a[3], gfx->data.bgColor); break;
+    case GDC_ELLIPSE: graphicsDrawEllipse(gfx, a[0], a[1], a[2], a[3]); break;
+    case GDC_FILLELLIPSE: graphicsFillEllipse(gfx, a[0], a[1], a[2], a[3]); break;
+    case GDC_CIRCLE: graphicsDrawEllipse(gfx, a[0]-a[2], a[1]-a[2], a[0]+a[2], a[1]+a[2]); break;
+    case GDC_FILLCIRCLE: graphicsFillEllipse(gfx, a[0]-a[2], a[1]-a[2], a[0]+a[2], a[1]+a[2]); break;
+    case GDC_POLY:
+    case GDC_FILLPOLY:
+      if (!jsvIsIterable(firstArg)) {
+        jsExceptionHere(JSET_TYPEERROR, "Expecting an array of vertices, got %t", firstArg);
+        jsvUnLock2(firstArg, colArg);
+        return false;
+      }
+      if (c==GDC_POLY) jswrap_graphics_drawPolyGfx(gfx, firstArg, closed);
+      else jswrap_graphics_fillPolyGfx(gfx, firstArg);
+      break;
+    case GDC_COLOR:
+    case GDC_BGCOLOR: {
+      unsigned int col = jswrap_graphics_toColor(parent, firstArg, 0, 0);
+      if (c==GDC_COLOR) gfx->data.fgColor = col;
+      else gfx->data.bgColor = col;
+      break;
+    }
+    default:
+      jsExceptionHere(JSET_ERROR, "Unknown draw command \"%s\"", name);
+      jsvUnLock2(firstArg, colArg);
+      return false;
+  }
+  jsvUnLock2(firstArg, colArg);
+  return true;
+}
+
+JsVar *jswrap_graphics_draw(JsVar *parent, JsVar *commands) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  if (!jsvIsIterable(commands)) {
+    jsExceptionHere(JSET_TYPEERROR, "Expecting an Array of draw commands, got %t", commands);
+    return 0;
+  }
+  JsvIterator it;
+  jsvIteratorNew(&it, commands, JSIF_EVERY_ARRAY_ELEMENT);
+  while (jsvIteratorHasElement(&it) && !jspIsInterrupted()) {
+    JsVar *cmd = jsvIteratorGetValue(&it);
+    bool ok = jswrap_graphics_drawCommand(parent, &gfx, cmd);
+    jsvUnLock(cmd);
+    if (!ok) break;
+    jsvIteratorNext(&it);
+  }
+  jsvIteratorFree(&it);
   graphicsSetVar(&gfx); // gfx data changed because modified area
   return jsvLockAgain(parent);
 }
@@ -1668,6 +2066,78 @@ JsVar *jswrap_graphics_setRotation(JsVar *parent, int rotation, bool reflect) {
   return jsvLockAgain(parent);
 }
 
+#ifdef USE_HEATSHRINK
+/// Read a `bpp` bit pixel (MSB-first) starting at bit offset `bit` of `data`
+static unsigned int jswrap_graphics_getImagePixel(const unsigned char *data, unsigned int bit, unsigned int bpp) {
+  unsigned int col = 0;
+  while (bpp) {
+    unsigned int avail = 8 - (bit&7);
+    unsigned int n = (bpp<avail) ? bpp : avail;
+    col = (col<<n) | ((unsigned int)(data[bit>>3] >> (avail-n)) & ((1U<<n)-1));
+    bit += n;
+    bpp -= n;
+  }
+  return col;
+}
+
+/** Draw a heatshrink-compressed image 1:1, decoding it one row at a time into a
+ * scanline buffer so the decompressed image never has to exist in RAM */
+static void jswrap_graphics_drawImageCompressed(JsGraphics *gfx, JsvStringIterator *it, int xPos, int yPos, int imageWidth, int imageHeight, JsGraphicsBlitSource *src) {
+  // rows aren't byte aligned, so a row may share its first byte with the end of the last one
+  size_t lineSize = (((size_t)imageWidth*src->bpp + 7)>>3) + 1;
+  if (lineSize > jsuGetFreeStack()/2) {
+    jsExceptionHere(JSET_ERROR, "Image too wide to decompress");
+    return;
+  }
+  unsigned char line[lineSize];
+  size_t lineStart = 0, lineLen = 0; // the range of the decompressed data that's in `line`
+  heatshrink_decoder hsd;
+  heatshrink_decoder_reset(&hsd);
+  bool canBlit = gfx->blitRow &&
+      (gfx->data.flags & (JSGRAPHICSFLAGS_SWAP_XY|JSGRAPHICSFLAGS_INVERT_X|JSGRAPHICSFLAGS_INVERT_Y))==0 &&
+      (src->bpp==1 || src->bpp==2 || src->bpp==4 || (src->bpp&7)==0);
+  int x1 = xPos, x2 = xPos+imageWidth-1;
+  if (x1<gfx->data.clipRect.x1) x1 = gfx->data.clipRect.x1;
+  if (x2>gfx->data.clipRect.x2) x2 = gfx->data.clipRect.x2;
+  int y;
+  for (y=0;y<imageHeight;y++) {
+    size_t rowBit = (size_t)y*(size_t)imageWidth*src->bpp;
+    size_t rowStart = rowBit>>3, rowEnd = (rowBit + (size_t)imageWidth*src->bpp + 7)>>3;
+    // keep any bytes we already have, and decompress the rest of the row after them
+    size_t keep = lineStart+lineLen - rowStart;
+    memmove(line, &line[rowStart-lineStart], keep);
+    lineStart = rowStart;
+    lineLen = keep + heatshrink_decoder_read(&hsd, heatshrink_str_input_cb, (uint32_t*)it, &line[keep], rowEnd-rowStart-keep);
+    if (lineLen < rowEnd-rowStart) break; // truncated image
+    int yp = yPos+y;
+    unsigned int bitOffset = (unsigned int)(rowBit - rowStart*8);
+    if (canBlit) {
+      if (yp<gfx->data.clipRect.y1 || yp>gfx->data.clipRect.y2 || x1>x2) continue;
+      src->data = line;
+      src->bitOffset = bitOffset + (unsigned int)(x1-xPos)*src->bpp;
+      gfx->blitRow(gfx, x1, yp, x2+1-x1, src);
+    } else {
+      int x;
+      for (x=0;x<imageWidth;x++) {
+        unsigned int col = jswrap_graphics_getImagePixel(line, bitOffset + (unsigned int)x*src->bpp, src->bpp);
+        if (col!=src->transparentCol) {
+          if (src->palette) col = src->palette[col&src->paletteMask];
+          graphicsSetPixel(gfx, xPos+x, yp, col);
+        }
+      }
+    }
+  }
+  if (canBlit) {
+    // update modified area since we went direct
+    int y1=yPos, y2=yPos+imageHeight-1;
+    if (y1<gfx->data.clipRect.y1) y1 = gfx->data.clipRect.y1;
+    if (y2>gfx->data.clipRect.y2) y2 = gfx->data.clipRect.y2;
+    if (x1<=x2 && y1<=y2)
+      graphicsSetModified(gfx, x1, y1, x2, y2);
+  }
+}
+#endif
+
 /*JSON{
   "type" : "method",
   "class" : "Graphics",
@@ -1684,8 +2154,18 @@ JsVar *jswrap_graphics_setRotation(JsVar *parent, int rotation, bool reflect) {
 }
 Image can be:
 
-* An object with the following fields `{ width : int, height : int, bpp : optional int, buffer : ArrayBuffer/String, transparent: optional int, palette : optional Uint16Array(2/4/16) }`. bpp = bits per pixel (default is 1), transparent (if defined) is the colour that will be treated as transparent, and palette is a color palette that each pixel will be looked up in first
-* A String where the the first few bytes are: `width,height,bpp,[transparent,]image_bytes...`. If a transparent colour is specified the top bit of `bpp` should be set.
+* An object with the following fields `{ width : int, height : int, bpp : optional int, buffer : ArrayBuffer/String, transparent: optional int, palette : optional Uint16Array(2/4/16), compressed : optional bool }`. bpp = bits per pixel (default is 1), transparent (if defined) is the colour that will be treated as transparent, and palette is a color palette that each pixel will be looked up in first
+* A String where the the first few bytes are: `width,height,bpp,[transparent,]image_bytes...`. If a transparent colour is specified the top bit of `bpp` should be set. If the image bytes are compressed, bit 6 (64) of `bpp` should be set.
+
+Compressed images have their image bytes compressed with `require("heatshrink").compress`, and are
+decompressed a row at a time while drawing, so an image stored in Flash never needs to be loaded
+into RAM. They can't be drawn with `options`. For example:
+
+```
+var img = g.asImage();
+require("Storage").write("img", E.toString(img.width, img.height, (img.bpp||1)|64, require("heatshrink").compress(img.buffer)));
+g.drawImage(require("Storage").read("img"), 0, 0);
+```
 
 Draw an image at the specified position.
 
@@ -1711,6 +2191,7 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
 
   int imageWidth, imageHeight, imageBpp;
   bool imageIsTransparent = false;
+  bool imageIsCompressed = false;
   unsigned int imageTransparentCol;
   JsVar *imageBuffer;
   int imageBufferOffset;
@@ -1719,15 +2200,41 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
   uint16_t simplePalette[4];
 
   if (jsvIsObject(image)) {
-    imageWidth = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(image, "width", 0));
-    imageHeight = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(image, "height", 0));
-    imageBpp = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(image, "bpp", 0));
+    // get all the fields we need in one pass, rather than searching for each one
+    JsVar *v = 0;
+    imageWidth = 0;
+    imageHeight = 0;
+    imageBpp = 0;
+    imageTransparentCol = 0;
+    imageBuffer = 0;
+    JsvObjectIterator oit;
+    jsvObjectIteratorNew(&oit, image);
+    while (jsvObjectIteratorHasValue(&oit)) {
+      JsVar *key = jsvObjectIteratorGetKey(&oit);
+      if (jsvIsStringEqual(key, "width"))
+        imageWidth = (int)jsvGetIntegerAndUnLock(jsvObjectIteratorGetValue(&oit));
+      else if (jsvIsStringEqual(key, "height"))
+        imageHeight = (int)jsvGetIntegerAndUnLock(jsvObjectIteratorGetValue(&oit));
+      else if (jsvIsStringEqual(key, "bpp"))
+        imageBpp = (int)jsvGetIntegerAndUnLock(jsvObjectIteratorGetValue(&oit));
+      else if (jsvIsStringEqual(key, "transparent")) {
+        JsVar *t = jsvObjectIteratorGetValue(&oit);
+        imageIsTransparent = t!=0;
+        imageTransparentCol = (unsigned int)jsvGetIntegerAndUnLock(t);
+      } else if (jsvIsStringEqual(key, "compressed")) {
+        imageIsCompressed = jsvGetBoolAndUnLock(jsvObjectIteratorGetValue(&oit));
+      } else if (jsvIsStringEqual(key, "palette")) {
+        jsvUnLock(v);
+        v = jsvObjectIteratorGetValue(&oit);
+      } else if (jsvIsStringEqual(key, "buffer")) {
+        jsvUnLock(imageBuffer);
+        imageBuffer = jsvObjectIteratorGetValue(&oit);
+      }
+      jsvUnLock(key);
+      jsvObjectIteratorNext(&oit);
+    }
+    jsvObjectIteratorFree(&oit);
     if (imageBpp<=0) imageBpp=1;
-    JsVar *v;
-    v = jsvObjectGetChild(image, "transparent", 0);
-    imageIsTransparent = v!=0;
-    imageTransparentCol = (unsigned int)jsvGetIntegerAndUnLock(v);
-    v = jsvObjectGetChild(image, "palette", 0);
     if (v) {
       if (jsvIsArrayBuffer(v) && v->varData.arraybuffer.type==ARRAYBUFFERVIEW_UINT16) {
         size_t l = 0;
@@ -1742,11 +2249,10 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
         jsvUnLock(v);
       if (!palettePtr) {
         jsExceptionHere(JSET_ERROR, "palette specified, but must be a flat Uint16Array of 2,4, or 16 elements");
+        jsvUnLock(imageBuffer);
         return 0;
       }
     }
-
-    imageBuffer = jsvObjectGetChild(image, "buffer", 0);
     imageBufferOffset = 0;
   } else if (jsvIsString(image) || jsvIsArrayBuffer(image)) {
     if (jsvIsArrayBuffer(image)) {
@@ -1761,14 +2267,17 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
     imageWidth = (unsigned char)jsvGetCharInString(imageBuffer,0);
     imageHeight = (unsigned char)jsvGetCharInString(imageBuffer,1);
     imageBpp = (unsigned char)jsvGetCharInString(imageBuffer,2);
+    if (imageBpp & 64) {
+      imageIsCompressed = true;
+    }
     if (imageBpp & 128) {
-      imageBpp = imageBpp&127;
       imageIsTransparent = true;
       imageTransparentCol = (unsigned char)jsvGetCharInString(imageBuffer,3);
       imageBufferOffset = 4;
     } else {
       imageBufferOffset = 3;
     }
+    imageBpp = imageBpp&63;
   } else {
     jsExceptionHere(JSET_ERROR, "Expecting first argument to be an object or a String");
     return 0;
@@ -1821,6 +2330,9 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
   if (!(jsvIsArrayBuffer(imageBuffer) || jsvIsString(imageBuffer)) ||
       imageWidth<=0 ||
       imageHeight<=0 ||
+#ifndef USE_HEATSHRINK
+      imageIsCompressed ||
+#endif
       imageBpp>32) {
     jsExceptionHere(JSET_ERROR, "Expecting first argument to a valid Image");
     jsvUnLock(imageBuffer);
@@ -1838,14 +2350,55 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
   JsvStringIterator it;
   jsvStringIteratorNew(&it, imageBufferString, (size_t)imageBufferOffset);
 
+#ifdef USE_HEATSHRINK
+  if (imageIsCompressed) {
+    if (jsvIsUndefined(options)) {
+      JsGraphicsBlitSource src;
+      src.bpp = (unsigned int)imageBpp;
+      src.palette = palettePtr;
+      src.paletteMask = paletteMask;
+      src.transparentCol = imageTransparentCol;
+      jswrap_graphics_drawImageCompressed(&gfx, &it, xPos, yPos, imageWidth, imageHeight, &src);
+    } else
+      jsExceptionHere(JSET_ERROR, "Compressed images can't be scaled or rotated");
+  } else
+#endif
   if (jsvIsUndefined(options)) {
     // Standard 1:1 blitting
 #ifdef GRAPHICS_FAST_PATHS
     bool fastPath =
         (gfx.data.flags & (JSGRAPHICSFLAGS_SWAP_XY|JSGRAPHICSFLAGS_INVERT_X|JSGRAPHICSFLAGS_INVERT_Y))==0; // no messing with coordinates
+    size_t imageDataLen = 0;
+    const unsigned char *imageData = 0;
+    if (fastPath && gfx.blitRow &&
+        (imageBpp==1 || imageBpp==2 || imageBpp==4 || (imageBpp&7)==0)) {
+      imageData = (const unsigned char*)jsvGetDataPointer(imageBufferString, &imageDataLen);
+      // make sure the image isn't truncated
+      if (imageData && imageDataLen < (size_t)imageBufferOffset + (((size_t)imageWidth*(size_t)imageHeight*(size_t)imageBpp + 7)>>3))
+        imageData = 0;
+    }
+    if (imageData) { // the image is in flat memory, and the device can draw whole rows
+      JsGraphicsBlitSource src;
+      src.data = imageData + imageBufferOffset;
+      src.bpp = (unsigned int)imageBpp;
+      src.palette = palettePtr;
+      src.paletteMask = paletteMask;
+      src.transparentCol = imageTransparentCol;
+      int x1 = xPos, x2 = xPos+imageWidth-1;
+      if (x1<gfx.data.clipRect.x1) x1 = gfx.data.clipRect.x1;
+      if (x2>gfx.data.clipRect.x2) x2 = gfx.data.clipRect.x2;
+      if (x1<=x2) {
+        for (y=0;y<imageHeight;y++) {
+          int yp = yPos+y;
+          if (yp<gfx.data.clipRect.y1 || yp>gfx.data.clipRect.y2) continue;
+          src.bitOffset = (unsigned int)((y*imageWidth + (x1-xPos))*imageBpp);
+          gfx.blitRow(&gfx, x1, yp, x2+1-x1, &src);
+        }
+      }
+    }
     if (fastPath) { // fast path for standard blit
       int yp = yPos;
-      for (y=0;y<imageHeight;y++) {
+      for (y=0;y<imageHeight && !imageData;y++) {
         int xp = xPos;
         for (x=0;x<imageWidth;x++) {
           // Get the data we need...
@@ -1874,10 +2427,7 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
       if (y1<gfx.data.clipRect.y1) y1 = gfx.data.clipRect.y1;
       if (x2>gfx.data.clipRect.x2) x2 = gfx.data.clipRect.x2;
       if (y2>gfx.data.clipRect.y2) y2 = gfx.data.clipRect.y2;
-      if (x1 < gfx.data.modMinX) gfx.data.modMinX=(short)x1;
-      if (x2 > gfx.data.modMaxX) gfx.data.modMaxX=(short)x2;
-      if (y1 < gfx.data.modMinY) gfx.data.modMinY=(short)y1;
-      if (y2 > gfx.data.modMaxY) gfx.data.modMaxY=(short)y2;
+      graphicsSetModified(&gfx, x1, y1, x2, y2);
     } else { // handle rotation, and default to center the image
 #else
     if (true) {
@@ -1970,10 +2520,7 @@ JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos
       if (y1<gfx.data.clipRect.y1) y1 = gfx.data.clipRect.y1;
       if (x2>gfx.data.clipRect.x2) x2 = gfx.data.clipRect.x2;
       if (y2>gfx.data.clipRect.y2) y2 = gfx.data.clipRect.y2;
-      if (x1 < gfx.data.modMinX) gfx.data.modMinX=(short)x1;
-      if (x2 > gfx.data.modMaxX) gfx.data.modMaxX=(short)x2;
-      if (y1 < gfx.data.modMinY) gfx.data.modMinY=(short)y1;
-      if (y2 > gfx.data.modMaxY) gfx.data.modMaxY=(short)y2;
+      graphicsSetModified(&gfx, x1, y1, x2, y2);
     } else { // handle rotation, and default to center the image
 #else
     if (true) {
@@ -2120,10 +2667,86 @@ JsVar *jswrap_graphics_getModified(JsVar *parent, bool reset) {
     }
   }
   if (reset) {
-    gfx.data.modMaxX = -32768;
-    gfx.data.modMaxY = -32768;
-    gfx.data.modMinX = 32767;
-    gfx.data.modMinY = 32767;
+    graphicsResetModified(&gfx);
+    graphicsSetVar(&gfx);
+  }
+  return obj;
+#else
+  return 0;
+#endif
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "getModifiedRegions",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_getModifiedRegions",
+  "params" : [
+    ["reset","bool","Whether to reset the modified area or not"]
+  ],
+  "return" : ["JsVar","An array of `{x1,y1,x2,y2}` objects, one for each separate modified area"]
+}
+Like `getModified`, but rather than one rectangle surrounding everything that
+has been modified, this returns up to 4 separate rectangles. Areas that are
+close together are merged.
+
+This is what displays use when flipping, so that if (for example) two small
+areas in opposite corners are changed only those areas need to be sent.
+Coordinates are device coordinates, as with `getModified`.
+*/
+JsVar *jswrap_graphics_getModifiedRegions(JsVar *parent, bool reset) {
+#ifndef SAVE_ON_FLASH
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  JsVar *arr = jsvNewEmptyArray();
+  if (!arr) return 0;
+  for (int i=0;i<gfx.data.modRectCount;i++) {
+    JsVar *obj = jsvNewObject();
+    if (!obj) break;
+    jsvObjectSetChildAndUnLock(obj, "x1", jsvNewFromInteger(gfx.data.modRects[i].x1));
+    jsvObjectSetChildAndUnLock(obj, "y1", jsvNewFromInteger(gfx.data.modRects[i].y1));
+    jsvObjectSetChildAndUnLock(obj, "x2", jsvNewFromInteger(gfx.data.modRects[i].x2));
+    jsvObjectSetChildAndUnLock(obj, "y2", jsvNewFromInteger(gfx.data.modRects[i].y2));
+    jsvArrayPushAndUnLock(arr, obj);
+  }
+  if (reset) {
+    graphicsResetModified(&gfx);
+    graphicsSetVar(&gfx);
+  }
+  return arr;
+#else
+  return 0;
+#endif
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "getFlipStats",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_graphics_getFlipStats",
+  "params" : [
+    ["reset","bool","Whether to reset the counters or not"]
+  ],
+  "return" : ["JsVar","An object `{flips, bytes}`"]
+}
+For built-in displays that send only the modified areas when `g.flip()` is
+called, this returns how many times the display has been flipped and how many
+bytes of pixel data were sent to it in total.
+
+Graphics instances that don't send data to a display (eg. ArrayBuffers) will
+always return 0.
+*/
+JsVar *jswrap_graphics_getFlipStats(JsVar *parent, bool reset) {
+#ifndef SAVE_ON_FLASH
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  JsVar *obj = jsvNewObject();
+  if (!obj) return 0;
+  jsvObjectSetChildAndUnLock(obj, "flips", jsvNewFromInteger((JsVarInt)gfx.data.flipCount));
+  jsvObjectSetChildAndUnLock(obj, "bytes", jsvNewFromInteger((JsVarInt)gfx.data.flipBytes));
+  if (reset) {
+    gfx.data.flipCount = 0;
+    gfx.data.flipBytes = 0;
     graphicsSetVar(&gfx);
   }
   return obj;
@@ -2333,3 +2956,44 @@ JsVar *jswrap_graphics_quadraticBezier( JsVar *parent, JsVar *arr, JsVar *option
 
   return  result;
 }
+
+/*JSON{
+  "type" : "method",
+  "class" : "Graphics",
+  "name" : "drawBezier",
+  "#if" : "!defined(SAVE_ON_FLASH) && !defined(ESPRUINOBOARD)",
+  "generate" : "jswrap_graphics_drawBezier",
+  "params" : [
+    ["arr","JsVar","The start point, control point(s) and end point: ```[x0,y0,x1,y1,x2,y2]``` for a quadratic curve or ```[x0,y0,x1,y1,x2,y2,x3,y3]``` for a cubic one"],
+    ["antialias","bool","Whether to draw the curve anti-aliased (see `drawLineAA`)"]
+  ],
+  "return" : ["JsVar","The instance of Graphics this was called on, to allow call chaining"],
+  "return_object" : "Graphics"
+}
+Draw a quadratic or cubic Bezier curve in the current foreground color.
+
+Unlike `quadraticBezier`, no points are returned - the curve is split into however many straight
+lines are needed for it to be accurate to 1/4 pixel, and they are drawn directly.
+*/
+JsVar *jswrap_graphics_drawBezier(JsVar *parent, JsVar *arr, bool antialias) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+  double xy[8];
+  int n = 0;
+  if (jsvIsIterable(arr)) {
+    JsvIterator it;
+    jsvIteratorNew(&it, arr, JSIF_EVERY_ARRAY_ELEMENT);
+    while (jsvIteratorHasElement(&it) && n<8) {
+      xy[n++] = jsvIteratorGetFloatValue(&it);
+      jsvIteratorNext(&it);
+    }
+    if (jsvIteratorHasElement(&it)) n = 0; // too many
+    jsvIteratorFree(&it);
+  }
+  if (n!=6 && n!=8) {
+    jsExceptionHere(JSET_ERROR, "Expecting an array of 6 or 8 coordinates");
+    return 0;
+  }
+  graphicsDrawBezier(&gfx, n/2, xy, antialias);
+  graphicsSetVar(&gfx); // gfx data changed because modified area
+  return jsvLockAgain(parent);
+}
@@ -26,6 +26,9 @@ extern const uint16_t PALETTE_8BIT[256];
 
 bool jswrap_graphics_idle();
 void jswrap_graphics_init();
+#ifndef SAVE_ON_FLASH
+void jswrap_graphics_kill();
+#endif
 
 JsVar *jswrap_graphics_getInstance();
 // For creating graphics classes
@@ -34,6 +37,9 @@ JsVar *jswrap_graphics_createCallback(int width, int height, int bpp, JsVar *cal
 #ifdef USE_LCD_SDL
 JsVar *jswrap_graphics_createSDL(int width, int height, int bpp);
 #endif
+#ifdef USE_LCD_LINUX
+JsVar *jswrap_graphics_createFramebuffer(JsVar *path, JsVar *options);
+#endif
 JsVar *jswrap_graphics_createImage(JsVar *data);
 
 
@@ -44,6 +50,7 @@ JsVar *jswrap_graphics_fillRect(JsVar *parent, int x1, int y1, int x2, int y2);
 JsVar *jswrap_graphics_clearRect(JsVar *parent, int x1, int y1, int x2, int y2);
 JsVar *jswrap_graphics_drawRect(JsVar *parent, int x1, int y1, int x2, int y2);
 JsVar *jswrap_graphics_drawCircle(JsVar *parent, int x, int y, int rad);
+JsVar *jswrap_graphics_drawCircleAA(JsVar *parent, double x, double y, double rad);
 JsVar *jswrap_graphics_fillCircle(JsVar *parent, int x, int y, int rad);
 JsVar *jswrap_graphics_drawEllipse(JsVar *parent, int x, int y, int x2, int y2);
 JsVar *jswrap_graphics_fillEllipse(JsVar *parent, int x, int y, int x2, int y2);
@@ -61,19 +68,26 @@ JsVar *jswrap_graphics_getFont(JsVar *parent);
 JsVar *jswrap_graphics_getFonts(JsVar *parent);
 int jswrap_graphics_getFontHeight(JsVar *parent);
 JsVar *jswrap_graphics_drawString(JsVar *parent, JsVar *str, int x, int y, bool solidBackground);
+void jswrap_graphics_setGlyphCacheSize(int size);
+JsVar *jswrap_graphics_getGlyphCacheStats();
 void jswrap_graphics_drawCString(JsGraphics *gfx, int x, int y, char *str); /// Convenience function for using drawString from C code
 JsVarInt jswrap_graphics_stringWidth(JsVar *parent, JsVar *var);
 JsVar *jswrap_graphics_drawLine(JsVar *parent, int x1, int y1, int x2, int y2);
+JsVar *jswrap_graphics_drawLineAA(JsVar *parent, double x1, double y1, double x2, double y2);
 JsVar *jswrap_graphics_lineTo(JsVar *parent, int x, int y);
 JsVar *jswrap_graphics_moveTo(JsVar *parent, int x, int y);
 JsVar *jswrap_graphics_drawPoly(JsVar *parent, JsVar *poly, bool closed);
 JsVar *jswrap_graphics_fillPoly(JsVar *parent, JsVar *poly);
+JsVar *jswrap_graphics_draw(JsVar *parent, JsVar *commands);
 JsVar *jswrap_graphics_setRotation(JsVar *parent, int rotation, bool reflect);
 JsVar *jswrap_graphics_drawImage(JsVar *parent, JsVar *image, int xPos, int yPos, JsVar *options);
 JsVar *jswrap_graphics_asImage(JsVar *parent);
 JsVar *jswrap_graphics_getModified(JsVar *parent, bool reset);
+JsVar *jswrap_graphics_getModifiedRegions(JsVar *parent, bool reset);
+JsVar *jswrap_graphics_getFlipStats(JsVar *parent, bool reset);
 JsVar *jswrap_graphics_scroll(JsVar *parent, int x, int y);
 JsVar *jswrap_graphics_asBMP(JsVar *parent);
 JsVar *jswrap_graphics_asURL(JsVar *parent);
 void jswrap_graphics_dump(JsVar *parent);
 JsVar *jswrap_graphics_quadraticBezier(JsVar *parent, JsVar * arr, JsVar *options);
+JsVar *jswrap_graphics_drawBezier(JsVar *parent, JsVar *arr, bool antialias);
@@ -15,6 +15,12 @@
 #include "lcd_arraybuffer.h"
 #include "jsvar.h"
 #include "jsvariterator.h"
+#include "jsparse.h"
+#include "jswrap_promise.h"
+#include "jswrapper.h"
+#ifdef USE_LCD_LINUX
+#include "lcd_linux.h"
+#endif
 
 #ifndef SAVE_ON_FLASH
 #ifndef ESPRUINOBOARD
@@ -129,7 +135,7 @@ void  lcdFillRect_ArrayBuffer(struct JsGraphics *gfx, int x1, int y1, int x2, in
     lcdSetPixels_ArrayBuffer(gfx, x1, y, 1+x2-x1, col);
 }
 
-#ifndef GRAPHICS_ARRAYBUFFER_OPTIMISATIONS
+#ifdef GRAPHICS_ARRAYBUFFER_OPTIMISATIONS
 // Faster implementation for where we have a flat memory area
 unsigned int lcdGetPixel_ArrayBuffer_flat(JsGraphics *gfx, int x, int y) {
   unsigned int col = 0;
@@ -178,7 +184,7 @@ void lcdSetPixels_ArrayBuffer_flat(JsGraphics *gfx, int x, int y, int pixelCount
           char c = (char)(col?0xFF:0);
           pixelCount = pixelCount+1 - (wholeBytes*8/gfx->data.bpp);
           while (wholeBytes--) {
-            *ptr = c;
+            *ptr = (unsigned char)c;
             ptr++;
           }
           continue;
@@ -188,17 +194,17 @@ void lcdSetPixels_ArrayBuffer_flat(JsGraphics *gfx, int x, int y, int pixelCount
       unsigned int existing = (unsigned int)*ptr;
       unsigned int bitIdx = (gfx->data.flags & JSGRAPHICSFLAGS_ARRAYBUFFER_MSB) ? 8-(idx+gfx->data.bpp) : idx;
       assert(ptr>=(unsigned char*)gfx->backendData && ptr<((unsigned char*)gfx->backendData + graphicsGetMemoryRequired(gfx)));
-      *ptr = (char)((existing&~(mask<<bitIdx)) | ((col&mask)<<bitIdx));
+      *ptr = (unsigned char)((existing&~(mask<<bitIdx)) | ((col&mask)<<bitIdx));
       if (gfx->data.flags & JSGRAPHICSFLAGS_ARRAYBUFFER_VERTICAL_BYTE) {
         ptr++;
       } else {
-        idx += bppStride;
+        idx += (unsigned int)bppStride;
         if (idx>=8) ptr++;
       }
     } else { // we're writing whole bytes
       int i;
       for (i=0;i<gfx->data.bpp;i+=8) {
-        *ptr = (char)(col >> i);
+        *ptr = (unsigned char)(col >> i);
         ptr++;
       }
     }
@@ -210,11 +216,244 @@ void lcdSetPixel_ArrayBuffer_flat(JsGraphics *gfx, int x, int y, unsigned int co
   lcdSetPixels_ArrayBuffer_flat(gfx, x, y, 1, col);
 }
 
+/* Can we use the fill/scroll kernels below? They need pixels stored in
+ * plain left-to-right rows, with pixels that don't straddle bytes. */
+static bool lcdIsSimpleLayout_ArrayBuffer_flat(JsGraphics *gfx) {
+  if (gfx->data.flags & (JSGRAPHICSFLAGS_ARRAYBUFFER_ZIGZAG|JSGRAPHICSFLAGS_ARRAYBUFFER_VERTICAL_BYTE|JSGRAPHICSFLAGS_ARRAYBUFFER_INTERLEAVEX))
+    return false;
+  int bpp = gfx->data.bpp;
+  return bpp==1 || bpp==2 || bpp==4 || (bpp&7)==0;
+}
+
+/// Set pixel in a byte for bpp<8, bit = bit index of the pixel within the byte
+static inline void lcdSetBits_ArrayBuffer_flat(JsGraphics *gfx, unsigned char *ptr, unsigned int bit, unsigned int col) {
+  unsigned int mask = (1U<<gfx->data.bpp)-1;
+  unsigned int bitIdx = (gfx->data.flags & JSGRAPHICSFLAGS_ARRAYBUFFER_MSB) ? 8-(bit+gfx->data.bpp) : bit;
+  *ptr = (unsigned char)((*ptr & ~(mask<<bitIdx)) | ((col&mask)<<bitIdx));
+}
+
+/** Fill a run of pixelCount pixels starting at bit index idx in a simple layout.
+ * Whole bytes are filled with memset/memcpy, which the C library does a
+ * machine word (or SIMD register) at a time. */
+static void lcdFillSpan_ArrayBuffer_flat(JsGraphics *gfx, unsigned int idx, unsigned int pixelCount, unsigned int col) {
+  unsigned char *ptr = (unsigned char*)gfx->backendData + (idx>>3);
+  unsigned int bpp = gfx->data.bpp;
+  if (bpp<8) {
+    unsigned int bit = idx&7;
+    // leading pixels up to a byte boundary
+    while (bit && pixelCount) {
+      lcdSetBits_ArrayBuffer_flat(gfx, ptr, bit, col);
+      pixelCount--;
+      bit += bpp;
+      if (bit>=8) {
+        bit = 0;
+        ptr++;
+      }
+    }
+    // whole bytes - the colour repeated in every pixel of the byte
+    unsigned int mask = (1U<<bpp)-1;
+    unsigned int pixelsPerByte = 8/bpp;
+    unsigned int bytes = pixelCount/pixelsPerByte;
+    memset(ptr, (int)((0xFF/mask)*(col&mask)), bytes);
+    ptr += bytes;
+    pixelCount -= bytes*pixelsPerByte;
+    // trailing pixels
+    for (bit=0;pixelCount;pixelCount--,bit+=bpp)
+      lcdSetBits_ArrayBuffer_flat(gfx, ptr, bit, col);
+  } else if (bpp==8) {
+    memset(ptr, (int)(col&0xFF), pixelCount);
+  } else {
+    // write one pixel, then keep doubling the area we've filled by copying it
+    unsigned int bytesPerPixel = bpp>>3;
+    size_t total = (size_t)pixelCount*bytesPerPixel;
+    if (!total) return;
+    unsigned int i;
+    for (i=0;i<bytesPerPixel;i++)
+      ptr[i] = (unsigned char)(col >> (i*8));
+    size_t done = bytesPerPixel;
+    while (done < total) {
+      size_t n = (total-done < done) ? total-done : done;
+      memcpy(&ptr[done], ptr, n);
+      done += n;
+    }
+  }
+}
+
 // Faster implementation for where we have a flat memory area
 void  lcdFillRect_ArrayBuffer_flat(struct JsGraphics *gfx, int x1, int y1, int x2, int y2, unsigned int col) {
   int y;
-  for (y=y1;y<=y2;y++)
-    lcdSetPixels_ArrayBuffer_flat(gfx, x1, y, 1+x2-x1, col);
+  if (!lcdIsSimpleLayout_ArrayBuffer_flat(gfx)) {
+    for (y=y1;y<=y2;y++)
+      lcdSetPixels_ArrayBuffer_flat(gfx, x1, y, 1+x2-x1, col);
+    return;
+  }
+  unsigned int bpp = gfx->data.bpp;
+  unsigned int width = gfx->data.width;
+  unsigned int pixelCount = (unsigned int)(1+x2-x1);
+  unsigned int strideBits = width*bpp;
+  unsigned int idx = ((unsigned int)x1 + (unsigned int)y1*width)*bpp;
+  if (pixelCount==width && !(strideBits&7)) {
+    // full rows (eg. clear()) - one contiguous area
+    lcdFillSpan_ArrayBuffer_flat(gfx, idx, pixelCount*(unsigned int)(1+y2-y1), col);
+  } else if (bpp>=8) {
+    // fill the first row, then copy it to the others
+    lcdFillSpan_ArrayBuffer_flat(gfx, idx, pixelCount, col);
+    unsigned char *first = (unsigned char*)gfx->backendData + (idx>>3);
+    unsigned char *ptr = first;
+    size_t rowBytes = (pixelCount*bpp)>>3;
+    for (y=y1+1;y<=y2;y++) {
+      ptr += strideBits>>3;
+      memcpy(ptr, first, rowBytes);
+    }
+  } else {
+    for (y=y1;y<=y2;y++) {
+      lcdFillSpan_ArrayBuffer_flat(gfx, idx, pixelCount, col);
+      idx += strideBits;
+    }
+  }
+}
+
+/// Scroll a flat buffer with memmove where we can. Leaves the unscrolled area undefined
+void lcdScroll_ArrayBuffer_flat(struct JsGraphics *gfx, int xdir, int ydir) {
+  if (xdir==0 && ydir==0) return;
+  int width = gfx->data.width, height = gfx->data.height;
+  unsigned int bpp = gfx->data.bpp;
+  size_t stride = ((size_t)width*bpp)>>3;
+  unsigned char *data = (unsigned char*)gfx->backendData;
+  int y;
+  // vertical - move whole rows
+  if (ydir && ydir>-height && ydir<height) {
+    int rows = height - (ydir>0 ? ydir : -ydir);
+    if (ydir>0) memmove(&data[(size_t)ydir*stride], data, (size_t)rows*stride);
+    else memmove(data, &data[(size_t)(-ydir)*stride], (size_t)rows*stride);
+  }
+  // horizontal - move within each row
+  if (xdir && xdir>-width && xdir<width) {
+    int pixels = width - (xdir>0 ? xdir : -xdir);
+    if (((unsigned int)xdir*bpp)&7) {
+      // not a whole number of bytes - go pixel by pixel
+      int x;
+      for (y=0;y<height;y++) {
+        if (xdir>0) {
+          for (x=pixels-1;x>=0;x--)
+            lcdSetPixel_ArrayBuffer_flat(gfx, x+xdir, y, lcdGetPixel_ArrayBuffer_flat(gfx, x, y));
+        } else {
+          for (x=0;x<pixels;x++)
+            lcdSetPixel_ArrayBuffer_flat(gfx, x, y, lcdGetPixel_ArrayBuffer_flat(gfx, x-xdir, y));
+        }
+      }
+    } else {
+      size_t offset = ((size_t)(xdir>0 ? xdir : -xdir)*bpp)>>3;
+      size_t bytes = ((size_t)pixels*bpp)>>3;
+      unsigned char *row = data;
+      for (y=0;y<height;y++,row+=stride) {
+        if (xdir>0) memmove(&row[offset], row, bytes);
+        else memmove(row, &row[offset], bytes);
+      }
+    }
+  }
+  graphicsSetModified(gfx, 0, 0, width-1, height-1);
+}
+/// Read a pixel from packed (MSB first) image data, where bit is the bit index of the pixel. bpp must be 1,2,4,8,16,24 or 32
+static inline unsigned int lcdBlitReadPixel(const unsigned char *data, unsigned int bit, unsigned int bpp) {
+  const unsigned char *p = &data[bit>>3];
+  if (bpp<8) // 1,2,4 bpp never straddle a byte
+    return ((unsigned int)*p >> (8-bpp-(bit&7))) & ((1U<<bpp)-1);
+  if (bpp==8) return *p;
+  if (bpp==16) return ((unsigned int)p[0]<<8) | p[1];
+  unsigned int col = ((unsigned int)p[0]<<16) | ((unsigned int)p[1]<<8) | p[2];
+  if (bpp==32) col = (col<<8) | p[3];
+  return col;
+}
+
+/* Draw a row of image pixels straight into a flat buffer. There are
+ * tight loops for each destination bpp, and a plain copy if the formats
+ * match and there's no palette or transparency. */
+void lcdBlitRow_ArrayBuffer_flat(JsGraphics *gfx, int x, int y, int count, const JsGraphicsBlitSource *src) {
+  const unsigned char *data = src->data;
+  const uint16_t *palette = src->palette;
+  unsigned int paletteMask = src->paletteMask;
+  unsigned int transparentCol = src->transparentCol;
+  unsigned int bit = src->bitOffset;
+  unsigned int srcBpp = src->bpp;
+  unsigned int dstBpp = gfx->data.bpp;
+  int i;
+  if (!lcdIsSimpleLayout_ArrayBuffer_flat(gfx)) {
+    for (i=0;i<count;i++,bit+=srcBpp) {
+      unsigned int c = lcdBlitReadPixel(data, bit, srcBpp);
+      if (c==transparentCol) continue;
+      if (palette) c = palette[c&paletteMask];
+      lcdSetPixel_ArrayBuffer_flat(gfx, x+i, y, c);
+    }
+    return;
+  }
+  unsigned int idx = ((unsigned int)x + (unsigned int)y*gfx->data.width)*dstBpp;
+  unsigned char *dst = (unsigned char*)gfx->backendData + (idx>>3);
+  bool plainCopy = !palette && transparentCol==0xFFFFFFFF && srcBpp==dstBpp && !(bit&7);
+  if (dstBpp==8) {
+    if (plainCopy) {
+      memcpy(dst, &data[bit>>3], (size_t)count);
+      return;
+    }
+    for (i=0;i<count;i++,bit+=srcBpp,dst++) {
+      unsigned int c = lcdBlitReadPixel(data, bit, srcBpp);
+      if (c==transparentCol) continue; // transparent pixels just skip the destination
+      if (palette) c = palette[c&paletteMask];
+      *dst = (unsigned char)c;
+    }
+  } else if (dstBpp==16) {
+    if (plainCopy) {
+      // image data is big endian, ArrayBuffers are little endian
+      const unsigned char *p = &data[bit>>3];
+      for (i=0;i<count;i++,p+=2,dst+=2) {
+        dst[0] = p[1];
+        dst[1] = p[0];
+      }
+      return;
+    }
+    if (srcBpp<8) {
+      unsigned int srcMask = (1U<<srcBpp)-1;
+      for (i=0;i<count;i++,bit+=srcBpp,dst+=2) {
+        unsigned int c = ((unsigned int)data[bit>>3] >> (8-srcBpp-(bit&7))) & srcMask;
+        if (c==transparentCol) continue;
+        if (palette) c = palette[c&paletteMask];
+        dst[0] = (unsigned char)c;
+        dst[1] = (unsigned char)(c>>8);
+      }
+    } else {
+      for (i=0;i<count;i++,bit+=srcBpp,dst+=2) {
+        unsigned int c = lcdBlitReadPixel(data, bit, srcBpp);
+        if (c==transparentCol) continue;
+        if (palette) c = palette[c&paletteMask];
+        dst[0] = (unsigned char)c;
+        dst[1] = (unsigned char)(c>>8);
+      }
+    }
+  } else if (dstBpp<8) {
+    unsigned int dstBit = idx&7;
+    for (i=0;i<count;i++,bit+=srcBpp) {
+      unsigned int c = lcdBlitReadPixel(data, bit, srcBpp);
+      if (c!=transparentCol) {
+        if (palette) c = palette[c&paletteMask];
+        lcdSetBits_ArrayBuffer_flat(gfx, dst, dstBit, c);
+      }
+      dstBit += dstBpp;
+      if (dstBit>=8) {
+        dstBit = 0;
+        dst++;
+      }
+    }
+  } else { // 24/32 bpp
+    unsigned int bytesPerPixel = dstBpp>>3;
+    for (i=0;i<count;i++,bit+=srcBpp,dst+=bytesPerPixel) {
+      unsigned int c = lcdBlitReadPixel(data, bit, srcBpp);
+      if (c==transparentCol) continue;
+      if (palette) c = palette[c&paletteMask];
+      unsigned int b;
+      for (b=0;b<bytesPerPixel;b++)
+        dst[b] = (unsigned char)(c >> (b*8));
+    }
+  }
 }
 #endif // GRAPHICS_ARRAYBUFFER_OPTIMISATIONS
 
@@ -224,20 +463,30 @@ void lcdInit_ArrayBuffer(JsGraphics *gfx) {
   jsvUnLock2(jsvAddNamedChild(gfx->graphicsVar, buf, "buffer"), buf);
 }
 
+#ifdef GRAPHICS_ARRAYBUFFER_OPTIMISATIONS
+void lcdSetCallbacks_ArrayBuffer_flat(JsGraphics *gfx, void *data) {
+  gfx->backendData = data;
+  gfx->setPixel = lcdSetPixel_ArrayBuffer_flat;
+  gfx->getPixel = lcdGetPixel_ArrayBuffer_flat;
+  gfx->fillRect = lcdFillRect_ArrayBuffer_flat;
+  gfx->blitRow = lcdBlitRow_ArrayBuffer_flat;
+  // memmove works on whole rows, so they must start on a byte boundary
+  if (lcdIsSimpleLayout_ArrayBuffer_flat(gfx) && !((gfx->data.width*gfx->data.bpp)&7))
+    gfx->scroll = lcdScroll_ArrayBuffer_flat;
+}
+#endif
+
 void lcdSetCallbacks_ArrayBuffer(JsGraphics *gfx) {
   JsVar *buf = jsvObjectGetChild(gfx->graphicsVar, "buffer", 0);
-#ifndef GRAPHICS_ARRAYBUFFER_OPTIMISATIONS
+#ifdef GRAPHICS_ARRAYBUFFER_OPTIMISATIONS
   size_t len = 0;
   char *dataPtr = jsvGetDataPointer(buf, &len);
 #endif
   jsvUnLock(buf);
-#ifndef GRAPHICS_ARRAYBUFFER_OPTIMISATIONS
+#ifdef GRAPHICS_ARRAYBUFFER_OPTIMISATIONS
   if (dataPtr && len>=graphicsGetMemoryRequired(gfx)) {
     // nice fast mode
-    gfx->backendData = dataPtr;
-    gfx->setPixel = lcdSetPixel_ArrayBuffer_flat;
-    gfx->getPixel = lcdGetPixel_ArrayBuffer_flat;
-    gfx->fillRect = lcdFillRect_ArrayBuffer_flat;
+    lcdSetCallbacks_ArrayBuffer_flat(gfx, dataPtr);
 #else
   if (false) {
 #endif
@@ -250,3 +499,183 @@ void lcdSetCallbacks_ArrayBuffer(JsGraphics *gfx) {
     gfx->fillRect = lcdFillRect_ArrayBuffer;
   }
 }
+
+#ifndef SAVE_ON_FLASH
+void lcdForEachSpan_ArrayBuffer(int width, int bpp, const JsGraphicsModRect *r, void (*callback)(size_t start, size_t len, void *data), void *data) {
+  size_t w = (size_t)width, b = (size_t)bpp;
+  if (r->x1==0 && r->x2==width-1) { // whole rows, so it's all one run
+    size_t start = ((size_t)r->y1*w*b)>>3;
+    size_t end = (((size_t)r->y2+1)*w*b + 7)>>3;
+    callback(start, end-start, data);
+    return;
+  }
+  int y;
+  for (y=r->y1;y<=r->y2;y++) {
+    size_t start = (((size_t)y*w + (size_t)r->x1)*b)>>3;
+    size_t end = (((size_t)y*w + (size_t)r->x2 + 1)*b + 7)>>3;
+    callback(start, end-start, data);
+  }
+}
+
+typedef struct {
+  unsigned char *dst;
+  const unsigned char *src;
+  unsigned int bytes;
+} LcdCopySpanInfo;
+
+static void lcdCopySpan_ArrayBuffer(size_t start, size_t len, void *data) {
+  LcdCopySpanInfo *info = (LcdCopySpanInfo*)data;
+  memcpy(&info->dst[start], &info->src[start], len);
+  info->bytes += (unsigned int)len;
+}
+
+unsigned int lcdCopyRects_ArrayBuffer(int width, int bpp, const JsGraphicsModRect *rects, int rectCount, unsigned char *dst, const unsigned char *src) {
+  LcdCopySpanInfo copy;
+  copy.dst = dst;
+  copy.src = src;
+  copy.bytes = 0;
+  int i;
+  for (i=0;i<rectCount;i++)
+    lcdForEachSpan_ArrayBuffer(width, bpp, &rects[i], lcdCopySpan_ArrayBuffer, &copy);
+  return copy.bytes;
+}
+
+#ifdef USE_LCD_LINUX
+static bool lcdFlipPending = false; ///< is there a frame being sent with a Promise in hiddenRoot.GfxFlip?
+
+/// Wait for the frame that's being sent, and resolve its Promise
+static void lcdFlipFinish_ArrayBuffer() {
+  if (!lcdFlipPending) return;
+  lcdFlipPending = false;
+  bool ok = lcdFlipWait_Linux();
+  JsVar *flip = jsvObjectGetChild(execInfo.hiddenRoot, "GfxFlip", 0);
+  JsVar *promise = jsvObjectGetChild(flip, "promise", 0);
+  if (ok) jspromise_resolve(promise, 0);
+  else {
+    JsVar *err = jsvNewFromString("Unable to write frame");
+    jspromise_reject(promise, err);
+    jsvUnLock(err);
+  }
+  jsvUnLock2(promise, flip);
+  jsvObjectRemoveChild(execInfo.hiddenRoot, "GfxFlip");
+}
+#endif
+
+/// Create an ArrayBuffer for the Graphics that's always flat, even if it's small
+static JsVar *lcdNewFlatBuffer_ArrayBuffer(JsGraphics *gfx) {
+  unsigned int len = (unsigned int)graphicsGetMemoryRequired(gfx);
+  JsVar *str = jsvNewFlatStringOfLength(len);
+  if (!str) return 0;
+  JsVar *buf = jsvNewArrayBufferFromString(str, len);
+  jsvUnLock(str);
+  return buf;
+}
+
+bool lcdInitDoubleBuffer_ArrayBuffer(JsGraphics *gfx, JsVar *output) {
+  // we need raw pointers so the frame can be sent while JS carries on
+  JsVar *back = lcdNewFlatBuffer_ArrayBuffer(gfx);
+  JsVar *front = lcdNewFlatBuffer_ArrayBuffer(gfx);
+  if (!back || !front) {
+    jsvUnLock2(back, front);
+    jsExceptionHere(JSET_ERROR, "Not enough memory to double buffer");
+    return false;
+  }
+  jsvObjectSetChildAndUnLock(gfx->graphicsVar, "buffer", back);
+  jsvObjectSetChildAndUnLock(gfx->graphicsVar, JS_HIDDEN_CHAR_STR"fbuf", front);
+  if (output) {
+#ifdef USE_LCD_LINUX
+    if (!jsvIsString(output)) {
+      jsExceptionHere(JSET_ERROR, "output should be a String, got %t", output);
+      return false;
+    }
+    jsvObjectSetChild(gfx->graphicsVar, JS_HIDDEN_CHAR_STR"fout", output);
+#else
+    jsExceptionHere(JSET_ERROR, "output is not supported on this device");
+    return false;
+#endif
+  }
+  JsVar *fn = jsvNewNativeFunction((void (*)(void))lcdFlip_ArrayBuffer, JSWAT_JSVAR|JSWAT_THIS_ARG);
+  jsvObjectSetChildAndUnLock(gfx->graphicsVar, "flip", fn);
+  return true;
+}
+
+JsVar *lcdFlip_ArrayBuffer(JsVar *parent) {
+  JsGraphics gfx; if (!graphicsGetFromVar(&gfx, parent)) return 0;
+#ifdef USE_LCD_LINUX
+  // the last frame must have been sent before we can draw over it
+  lcdFlipFinish_ArrayBuffer();
+#endif
+  JsVar *back = jsvObjectGetChild(parent, "buffer", 0);
+  JsVar *front = jsvObjectGetChild(parent, JS_HIDDEN_CHAR_STR"fbuf", 0);
+  size_t backLen = 0, frontLen = 0;
+  unsigned char *backPtr = (unsigned char*)jsvGetDataPointer(back, &backLen);
+  unsigned char *frontPtr = (unsigned char*)jsvGetDataPointer(front, &frontLen);
+  size_t len = graphicsGetMemoryRequired(&gfx);
+  if (!backPtr || !frontPtr || backLen<len || frontLen<len) {
+    jsvUnLock2(back, front);
+    jsExceptionHere(JSET_ERROR, "Graphics isn't double buffered");
+    return 0;
+  }
+  // the frame we just drew becomes the front buffer...
+  jsvObjectSetChild(parent, "buffer", front);
+  jsvObjectSetChild(parent, JS_HIDDEN_CHAR_STR"fbuf", back);
+  JsGraphicsModRect rects[GRAPHICS_MOD_RECTS];
+  int rectCount = gfx.data.modRectCount;
+  memcpy(rects, gfx.data.modRects, sizeof(rects));
+  if (rectCount && (gfx.data.flags & (JSGRAPHICSFLAGS_ARRAYBUFFER_ZIGZAG|JSGRAPHICSFLAGS_ARRAYBUFFER_VERTICAL_BYTE|JSGRAPHICSFLAGS_ARRAYBUFFER_INTERLEAVEX))) {
+    // modified areas aren't contiguous in these layouts, so just use everything
+    rects[0].x1 = 0;
+    rects[0].y1 = 0;
+    rects[0].x2 = (short)(gfx.data.width-1);
+    rects[0].y2 = (short)(gfx.data.height-1);
+    rectCount = 1;
+  }
+  // ... and the new back buffer is brought up to date with it
+  unsigned int bytes = lcdCopyRects_ArrayBuffer(gfx.data.width, gfx.data.bpp, rects, rectCount, frontPtr, backPtr);
+  JsVar *promise = jspromise_create();
+  bool sending = false;
+#ifdef USE_LCD_LINUX
+  JsVar *output = jsvObjectGetChild(parent, JS_HIDDEN_CHAR_STR"fout", 0);
+  if (output && rectCount && promise) {
+    char path[256];
+    jsvGetString(output, path, sizeof(path));
+    sending = lcdFlipStart_Linux(path, backPtr, gfx.data.width, gfx.data.height, gfx.data.bpp, rects, rectCount);
+    if (sending) {
+      // keep the buffer referenced until it's sent, even if the Graphics goes away
+      JsVar *flip = jsvNewObject();
+      if (flip) {
+        jsvObjectSetChild(flip, "promise", promise);
+        jsvObjectSetChild(flip, "buffer", back);
+        jsvObjectSetChildAndUnLock(execInfo.hiddenRoot, "GfxFlip", flip);
+      }
+      lcdFlipPending = true;
+    } else
+      jsExceptionHere(JSET_ERROR, "Unable to start sending frame");
+  }
+  jsvUnLock(output);
+#endif
+  if (!sending && promise)
+    jspromise_resolve(promise, 0);
+  gfx.data.flipCount++;
+  gfx.data.flipBytes += bytes;
+  graphicsResetModified(&gfx);
+  graphicsSetVar(&gfx);
+  jsvUnLock2(back, front);
+  return promise;
+}
+
+bool lcdIdle_ArrayBuffer() {
+#ifdef USE_LCD_LINUX
+  if (lcdFlipBusy_Linux()) return true;
+  lcdFlipFinish_ArrayBuffer();
+#endif
+  return false;
+}
+
+void lcdKill_ArrayBuffer() {
+#ifdef USE_LCD_LINUX
+  lcdKill_Linux();
+  lcdFlipPending = false;
+#endif
+}
+#endif
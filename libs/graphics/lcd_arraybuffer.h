@@ -15,3 +15,20 @@
 
 void lcdInit_ArrayBuffer(JsGraphics *gfx);
 void lcdSetCallbacks_ArrayBuffer(JsGraphics *gfx);
+/// Draw straight into the flat, unpadded buffer at `data` (which must be big enough for the whole Graphics)
+void lcdSetCallbacks_ArrayBuffer_flat(JsGraphics *gfx, void *data);
+
+#ifndef SAVE_ON_FLASH
+/// Call `callback` for each run of bytes in a (non-zigzag/interleaved) flat ArrayBuffer that holds the pixels in `r`
+void lcdForEachSpan_ArrayBuffer(int width, int bpp, const JsGraphicsModRect *r, void (*callback)(size_t start, size_t len, void *data), void *data);
+/// Copy the pixels in `rects` from one flat buffer to another. Returns the number of bytes copied
+unsigned int lcdCopyRects_ArrayBuffer(int width, int bpp, const JsGraphicsModRect *rects, int rectCount, unsigned char *dst, const unsigned char *src);
+/// Set up a second buffer so that `g.flip()` swaps buffers and sends the last frame out while the next is drawn
+bool lcdInitDoubleBuffer_ArrayBuffer(JsGraphics *gfx, JsVar *output);
+/// `g.flip()` for double-buffered ArrayBuffers - returns a Promise that resolves when the frame has been sent
+JsVar *lcdFlip_ArrayBuffer(JsVar *parent);
+/// Resolve the Promise from `lcdFlip_ArrayBuffer` once the frame has been sent. Returns true if a frame is still being sent
+bool lcdIdle_ArrayBuffer();
+/// Wait for any frame that is being sent to finish (and on Linux, unmap any framebuffer)
+void lcdKill_ArrayBuffer();
+#endif
@@ -0,0 +1,212 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2019 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Graphics Backends for Linux framebuffers, and for sending frames from a worker thread
+ * ----------------------------------------------------------------------------
+ */
+
+#include "platform_config.h"
+#include "jsutils.h"
+#include "lcd_linux.h"
+#include "lcd_arraybuffer.h"
+#include <pthread.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/fb.h>
+
+/// The flip that's in progress. Only one frame is ever sent at a time
+typedef struct {
+  char path[256];
+  const unsigned char *data;
+  int width, bpp;
+  JsGraphicsModRect rects[GRAPHICS_MOD_RECTS];
+  int rectCount;
+  int fd;
+  bool ok;
+  bool done; ///< set by the worker thread when it has finished
+  pthread_t thread;
+} LcdFlipLinux;
+
+static LcdFlipLinux lcdFlip;
+static bool lcdFlipRunning = false; ///< is there a thread we haven't joined yet?
+
+static void lcdFlipWriteSpan_Linux(size_t start, size_t len, void *data) {
+  LcdFlipLinux *flip = (LcdFlipLinux*)data;
+  while (flip->ok && len) {
+    ssize_t n = pwrite(flip->fd, &flip->data[start], len, (off_t)start);
+    if (n<=0) flip->ok = false;
+    else {
+      start += (size_t)n;
+      len -= (size_t)n;
+    }
+  }
+}
+
+static void *lcdFlipThread_Linux(void *arg) {
+  LcdFlipLinux *flip = (LcdFlipLinux*)arg;
+  flip->fd = open(flip->path, O_WRONLY|O_CREAT, 0644);
+  flip->ok = flip->fd>=0;
+  for (int i=0;i<flip->rectCount && flip->ok;i++)
+    lcdForEachSpan_ArrayBuffer(flip->width, flip->bpp, &flip->rects[i], lcdFlipWriteSpan_Linux, flip);
+  if (flip->fd>=0) close(flip->fd);
+  __atomic_store_n(&flip->done, true, __ATOMIC_RELEASE);
+  return 0;
+}
+
+bool lcdFlipStart_Linux(const char *path, const unsigned char *data, int width, int height, int bpp, const JsGraphicsModRect *rects, int rectCount) {
+  lcdFlipWait_Linux();
+  if (strlen(path) >= sizeof(lcdFlip.path)) return false;
+  strcpy(lcdFlip.path, path);
+  lcdFlip.data = data;
+  lcdFlip.width = width;
+  lcdFlip.bpp = bpp;
+  if (rectCount) {
+    memcpy(lcdFlip.rects, rects, sizeof(JsGraphicsModRect)*(size_t)rectCount);
+    lcdFlip.rectCount = rectCount;
+  } else { // the whole buffer
+    lcdFlip.rects[0].x1 = 0;
+    lcdFlip.rects[0].y1 = 0;
+    lcdFlip.rects[0].x2 = (short)(width-1);
+    lcdFlip.rects[0].y2 = (short)(height-1);
+    lcdFlip.rectCount = 1;
+  }
+  lcdFlip.done = false;
+  if (pthread_create(&lcdFlip.thread, NULL, lcdFlipThread_Linux, &lcdFlip))
+    return false;
+  lcdFlipRunning = true;
+  return true;
+}
+
+bool lcdFlipBusy_Linux() {
+  return lcdFlipRunning && !__atomic_load_n(&lcdFlip.done, __ATOMIC_ACQUIRE);
+}
+
+bool lcdFlipWait_Linux() {
+  if (!lcdFlipRunning) return true;
+  pthread_join(lcdFlip.thread, NULL);
+  lcdFlipRunning = false;
+  return lcdFlip.ok;
+}
+
+// ======================================================================
+
+/// The framebuffer that's mapped - there's only ever one, like the SDL backend
+typedef struct {
+  int fd;
+  unsigned char *map;
+  size_t mapSize;
+  size_t pageSize; ///< bytes per screen
+  int pages; ///< 1, or 2 if double buffered
+  int backPage; ///< the page we're drawing into
+  bool isDevice; ///< a real framebuffer that we can pan, not just a file
+  struct fb_var_screeninfo var;
+} LcdFramebufferLinux;
+
+static LcdFramebufferLinux lcdFb = { .fd = -1 };
+
+static void lcdFreeFramebuffer_Linux() {
+  if (lcdFb.map) munmap(lcdFb.map, lcdFb.mapSize);
+  if (lcdFb.fd>=0) close(lcdFb.fd);
+  lcdFb.map = 0;
+  lcdFb.fd = -1;
+}
+
+/// Show the given page of a real framebuffer (without waiting for vsync)
+static void lcdPanFramebuffer_Linux(int page) {
+  if (!lcdFb.isDevice) return;
+  lcdFb.var.xoffset = 0;
+  lcdFb.var.yoffset = (unsigned int)page * lcdFb.var.yres;
+  ioctl(lcdFb.fd, FBIOPAN_DISPLAY, &lcdFb.var);
+}
+
+bool lcdInitFramebuffer_Linux(const char *path, int *width, int *height, int *bpp, bool doubleBuffer) {
+  lcdFreeFramebuffer_Linux();
+  lcdFb.fd = open(path, O_RDWR);
+  if (lcdFb.fd<0) {
+    jsExceptionHere(JSET_ERROR, "Unable to open %s", path);
+    return false;
+  }
+  lcdFb.pages = doubleBuffer ? 2 : 1;
+  struct fb_fix_screeninfo fix;
+  lcdFb.isDevice = ioctl(lcdFb.fd, FBIOGET_VSCREENINFO, &lcdFb.var)==0 &&
+                   ioctl(lcdFb.fd, FBIOGET_FSCREENINFO, &fix)==0;
+  if (lcdFb.isDevice) {
+    if (doubleBuffer && lcdFb.var.yres_virtual < lcdFb.var.yres*2) {
+      // ask for room for a second page
+      lcdFb.var.yres_virtual = lcdFb.var.yres*2;
+      if (ioctl(lcdFb.fd, FBIOPUT_VSCREENINFO, &lcdFb.var) ||
+          ioctl(lcdFb.fd, FBIOGET_VSCREENINFO, &lcdFb.var) ||
+          ioctl(lcdFb.fd, FBIOGET_FSCREENINFO, &fix) ||
+          lcdFb.var.yres_virtual < lcdFb.var.yres*2) {
+        jsExceptionHere(JSET_ERROR, "Framebuffer can't be double buffered");
+        lcdFreeFramebuffer_Linux();
+        return false;
+      }
+    }
+    *bpp = (int)lcdFb.var.bits_per_pixel;
+    // the flat ArrayBuffer code expects unpadded rows, so any padding just becomes offscreen pixels
+    *width = (int)(fix.line_length*8 / lcdFb.var.bits_per_pixel);
+    *height = (int)lcdFb.var.yres;
+  } else if (*width<=0 || *height<=0 || *bpp<=0) {
+    jsExceptionHere(JSET_ERROR, "width, height and bpp must be given if %s isn't a framebuffer", path);
+    lcdFreeFramebuffer_Linux();
+    return false;
+  }
+  lcdFb.pageSize = ((size_t)*width * (size_t)*height * (size_t)*bpp + 7) >> 3;
+  lcdFb.mapSize = lcdFb.pageSize * (size_t)lcdFb.pages;
+  if (!lcdFb.isDevice) {
+    // a plain file - make sure it's big enough to map
+    struct stat st;
+    if (fstat(lcdFb.fd, &st) || ((size_t)st.st_size < lcdFb.mapSize && ftruncate(lcdFb.fd, (off_t)lcdFb.mapSize))) {
+      jsExceptionHere(JSET_ERROR, "Unable to resize %s", path);
+      lcdFreeFramebuffer_Linux();
+      return false;
+    }
+  }
+  void *map = mmap(0, lcdFb.mapSize, PROT_READ|PROT_WRITE, MAP_SHARED, lcdFb.fd, 0);
+  if (map==MAP_FAILED) {
+    jsExceptionHere(JSET_ERROR, "Unable to map %s", path);
+    lcdFreeFramebuffer_Linux();
+    return false;
+  }
+  lcdFb.map = (unsigned char*)map;
+  // show page 0, draw into the last page
+  lcdFb.backPage = lcdFb.pages-1;
+  if (doubleBuffer) lcdPanFramebuffer_Linux(0);
+  return true;
+}
+
+void lcdSetCallbacks_Framebuffer_Linux(JsGraphics *gfx) {
+  if (!lcdFb.map || graphicsGetMemoryRequired(gfx) > lcdFb.pageSize) return; // it's been unmapped
+  lcdSetCallbacks_ArrayBuffer_flat(gfx, &lcdFb.map[(size_t)lcdFb.backPage * lcdFb.pageSize]);
+}
+
+void lcdFlipFramebuffer_Linux(JsGraphics *gfx) {
+  if (lcdFb.map && lcdFb.pages>1) {
+    int front = lcdFb.backPage;
+    lcdPanFramebuffer_Linux(front);
+    lcdFb.backPage = front^1;
+    // bring the new back page up to date with what's now on screen
+    gfx->data.flipBytes += lcdCopyRects_ArrayBuffer(gfx->data.width, gfx->data.bpp,
+        gfx->data.modRects, gfx->data.modRectCount,
+        &lcdFb.map[(size_t)lcdFb.backPage * lcdFb.pageSize], &lcdFb.map[(size_t)front * lcdFb.pageSize]);
+    lcdSetCallbacks_Framebuffer_Linux(gfx);
+  }
+  gfx->data.flipCount++;
+  graphicsResetModified(gfx);
+}
+
+void lcdKill_Linux() {
+  lcdFlipWait_Linux();
+  lcdFreeFramebuffer_Linux();
+}
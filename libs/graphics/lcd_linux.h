@@ -0,0 +1,33 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2019 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Graphics Backends for Linux framebuffers, and for sending frames from a worker thread
+ * ----------------------------------------------------------------------------
+ */
+#include "graphics.h"
+
+/** Start writing the modified areas of a flat frame buffer to the file/device at `path`
+ * from a worker thread. `data` must stay valid and unchanged until the flip has finished.
+ * If rectCount is 0, the whole buffer is sent. Returns false if the flip couldn't be started. */
+bool lcdFlipStart_Linux(const char *path, const unsigned char *data, int width, int height, int bpp, const JsGraphicsModRect *rects, int rectCount);
+/// Is a flip still in progress?
+bool lcdFlipBusy_Linux();
+/// Wait for the current flip (if any) to finish. Returns false if it failed
+bool lcdFlipWait_Linux();
+
+/** Open and mmap a framebuffer device (or a plain file standing in for one). For a real device the size
+ * comes from the device and `width/height/bpp` are overwritten, for a file they must be given. If
+ * doubleBuffer is set, two pages are used and flipped between by panning. Returns false on error. */
+bool lcdInitFramebuffer_Linux(const char *path, int *width, int *height, int *bpp, bool doubleBuffer);
+void lcdSetCallbacks_Framebuffer_Linux(JsGraphics *gfx);
+/// Show the page that was drawn into (if double buffered), and bring the other page up to date
+void lcdFlipFramebuffer_Linux(JsGraphics *gfx);
+/// Wait for any flip and unmap the framebuffer
+void lcdKill_Linux();
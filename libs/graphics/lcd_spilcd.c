@@ -96,45 +96,43 @@ void lcdFlip_SPILCD_callback() {
   // just an empty stub for SPIsend - we'll just push data as fast as we can
 }
 
-void lcdFlip_SPILCD(JsGraphics *gfx) {
-  if (gfx->data.modMinX > gfx->data.modMaxX) return; // nothing to do!
-
+/// Send one area of lcdBuffer to the LCD. Returns the number of bytes of pixel data sent
+static unsigned int lcdFlip_SPILCD_rect(int x1, int y1, int x2, int y2) {
   unsigned char buffer1[LCD_WIDTH*2]; // 16 bits per pixel
   unsigned char buffer2[LCD_WIDTH*2]; // 16 bits per pixel
+  unsigned int bytes = 0;
 
   // use nearest 2 pixels as we're sending 12 bits
-  gfx->data.modMinX = (gfx->data.modMinX)&~1;
-  gfx->data.modMaxX = (gfx->data.modMaxX+2)&~1;
-  int xlen = gfx->data.modMaxX - gfx->data.modMinX;
-  int xstart = gfx->data.modMinX;
+  x1 = x1&~1;
+  x2 = (x2+2)&~1;
+  int xlen = x2 - x1;
+  int xstart = x1;
 
-  jshPinSetValue(LCD_SPI_CS, 0);
   jshPinSetValue(LCD_SPI_DC, 0); // command
   buffer1[0] = SPILCD_CMD_WINDOW_X;
   jshSPISendMany(LCD_SPI, buffer1, NULL, 1, NULL);
   jshPinSetValue(LCD_SPI_DC, 1); // data
   buffer1[0] = 0;
-  buffer1[1] = gfx->data.modMinX;
+  buffer1[1] = x1;
   buffer1[2] = 0;
-  buffer1[3] = gfx->data.modMaxX;
+  buffer1[3] = x2;
   jshSPISendMany(LCD_SPI, buffer1, NULL, 4, NULL);
   jshPinSetValue(LCD_SPI_DC, 0); // command
   buffer1[0] = SPILCD_CMD_WINDOW_Y;
   jshSPISendMany(LCD_SPI, buffer1, NULL, 1, NULL);
   jshPinSetValue(LCD_SPI_DC, 1); // data
   buffer1[0] = 0;
-  buffer1[1] = gfx->data.modMinY;
+  buffer1[1] = y1;
   buffer1[2] = 0;
-  buffer1[3] = gfx->data.modMaxY+1;
+  buffer1[3] = y2+1;
   jshSPISendMany(LCD_SPI, buffer1, NULL, 4, NULL);
   jshPinSetValue(LCD_SPI_DC, 0); // command
   buffer1[0] = SPILCD_CMD_DATA;
   jshSPISendMany(LCD_SPI, buffer1, NULL, 1, NULL);
   jshPinSetValue(LCD_SPI_DC, 1); // data
 
-  for (int y=gfx->data.modMinY;y<=gfx->data.modMaxY;y++) {
+  for (int y=y1;y<=y2;y++) {
     unsigned char *buffer = (y&1)?buffer1:buffer2;
-    // skip any lines that don't need updating
 #if LCD_BPP==4
     unsigned char *px = &lcdBuffer[y*LCD_STRIDE + (xstart>>1)];
 #endif
@@ -158,14 +156,28 @@ void lcdFlip_SPILCD(JsGraphics *gfx) {
     }
     size_t len = ((unsigned char*)bufPtr)-buffer;
     jshSPISendMany(LCD_SPI, buffer, 0, len, lcdFlip_SPILCD_callback);
+    bytes += len;
   }
+  // wait before buffer1/2 go out of scope (and before the next window command)
   jshSPIWait(LCD_SPI);
+  return bytes;
+}
+
+void lcdFlip_SPILCD(JsGraphics *gfx) {
+  if (gfx->data.modMinX > gfx->data.modMaxX) return; // nothing to do!
+
+  unsigned int bytes = 0;
+  jshPinSetValue(LCD_SPI_CS, 0);
+  // Only send the areas that were modified
+  for (int i=0;i<gfx->data.modRectCount;i++) {
+    JsGraphicsModRect *r = &gfx->data.modRects[i];
+    bytes += lcdFlip_SPILCD_rect(r->x1, r->y1, r->x2, r->y2);
+  }
   jshPinSetValue(LCD_SPI_CS,1);
+  gfx->data.flipCount++;
+  gfx->data.flipBytes += bytes;
   // Reset modified-ness
-  gfx->data.modMaxX = -32768;
-  gfx->data.modMaxY = -32768;
-  gfx->data.modMinX = 32767;
-  gfx->data.modMinY = 32767;
+  graphicsResetModified(gfx);
 }
 
 
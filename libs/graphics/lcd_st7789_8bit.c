@@ -202,6 +202,26 @@ LCDST7789Mode lcdST7789_getMode() {
   return lcdMode;
 }
 
+/// Blit an area of an 8 bit offscreen buffer to the LCD, scaling each pixel up by 'scale'. Returns the number of bytes sent
+static unsigned int lcdST7789_blitScaled(const unsigned char *dataPtr, int stride, int scale, int x1, int y1, int x2, int y2) {
+  int w = x2+1-x1;
+  int h = y2+1-y1;
+  lcdST7789_blitStart(x1*scale, y1*scale, w*scale-1, h*scale-1);
+  for (int y=y1;y<=y2;y++) {
+    // display the same row 'scale' times
+    for (int n=0;n<scale;n++) {
+      const unsigned char *px = &dataPtr[y*stride + x1];
+      for (int x=0;x<w;x++) {
+        uint16_t c = PALETTE_8BIT[*(px++)];
+        for (int s=0;s<scale;s++)
+          lcdST7789_blitPixel(c);
+      }
+    }
+  }
+  lcdST7789_blitEnd();
+  return (unsigned int)(w*h*scale*scale*2); // 16 bits per pixel
+}
+
 void lcdST7789_flip(JsGraphics *gfx) {
   unsigned char buf[2];
   switch (lcdMode) {
@@ -217,58 +237,33 @@ void lcdST7789_flip(JsGraphics *gfx) {
         lcdScrollY = 0;
       }
       lcdST7789_scrollCmd();
+      gfx->data.flipCount++;
     } break;
-    case LCDST7789_MODE_BUFFER_120x120: {
-      // offscreen buffer - BLIT
-      JsVar *buffer = jsvObjectGetChild(gfx->graphicsVar, "buffer", 0);
-      size_t len = 0;
-      unsigned char *dataPtr = (unsigned char*)jsvGetDataPointer(buffer, &len);
-      jsvUnLock(buffer);
-      if (dataPtr && len>=(120*120)) {
-        // reset scroll to 0
-        lcdScrollY = 0;
-        lcdST7789_scrollCmd();
-        // blit
-        lcdST7789_blitStart(0,0,239,239);
-        for (int y=0;y<240;y++) {
-          for (int x=0;x<120;x++) {
-            uint16_t c = PALETTE_8BIT[*(dataPtr++)];
-            lcdST7789_blitPixel(c);
-            lcdST7789_blitPixel(c);
-          }
-          // display the same row twice
-          if (!(y&1)) dataPtr -= 120;
-        }
-        lcdST7789_blitEnd();
-      }
-    } break;
+    case LCDST7789_MODE_BUFFER_120x120:
     case LCDST7789_MODE_BUFFER_80x80: {
-      // offscreen buffer - BLIT
+      // offscreen buffer - BLIT only the areas that were modified
+      int size = (lcdMode==LCDST7789_MODE_BUFFER_120x120) ? 120 : 80;
+      int scale = 240 / size;
       JsVar *buffer = jsvObjectGetChild(gfx->graphicsVar, "buffer", 0);
       size_t len = 0;
       unsigned char *dataPtr = (unsigned char*)jsvGetDataPointer(buffer, &len);
       jsvUnLock(buffer);
-      if (dataPtr && len>=(80*80)) {
+      if (dataPtr && len>=(size_t)(size*size)) {
         // reset scroll to 0
         lcdScrollY = 0;
         lcdST7789_scrollCmd();
         // blit
-        lcdST7789_blitStart(0,0,239,239);
-        for (int y=0;y<80;y++) {
-          for (int n=0;n<3;n++) {
-            for (int x=0;x<80;x++) {
-              uint16_t c = PALETTE_8BIT[*(dataPtr++)];
-              lcdST7789_blitPixel(c);
-              lcdST7789_blitPixel(c);
-              lcdST7789_blitPixel(c);
-            }
-            if (n<2) dataPtr -= 80;
-          }
+        unsigned int bytes = 0;
+        for (int i=0;i<gfx->data.modRectCount;i++) {
+          JsGraphicsModRect *r = &gfx->data.modRects[i];
+          bytes += lcdST7789_blitScaled(dataPtr, size, scale, r->x1, r->y1, r->x2, r->y2);
         }
-        lcdST7789_blitEnd();
+        gfx->data.flipCount++;
+        gfx->data.flipBytes += bytes;
       }
     } break;
   }
+  graphicsResetModified(gfx);
 }
 
 /// Starts a blit operation - call this, then blitPixel (a lot) then blitEnd. No bounds checking
@@ -136,10 +136,7 @@ void lcd_flip_gfx(JsGraphics *gfx) {
   jshPinSetValue(LCD_SPI_CS,1);
   jsvUnLock(buf);
   // Reset modified-ness
-  gfx->data.modMaxX = -32768;
-  gfx->data.modMaxY = -32768;
-  gfx->data.modMinX = 32767;
-  gfx->data.modMinY = 32767;
+  graphicsResetModified(gfx);
 }
 
 
@@ -148,10 +145,7 @@ void lcd_flip(JsVar *parent, bool all) {
   JsGraphics gfx; 
   if (!graphicsGetFromVar(&gfx, parent)) return;
   if (all) {
-    gfx.data.modMinX = 0;
-    gfx.data.modMinY = 0;
-    gfx.data.modMaxX = 127;
-    gfx.data.modMaxY = 63;
+    graphicsSetModified(&gfx, 0, 0, 127, 63);
   }
   lcd_flip_gfx(&gfx);
   graphicsSetVar(&gfx);
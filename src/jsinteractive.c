@@ -26,6 +26,9 @@
 #include "jswrap_interactive.h" // jswrap_interactive_setTimeout
 #include "jswrap_object.h" // jswrap_object_keys_or_property_names
 #include "jsnative.h" // jsnSanityTest
+#ifdef USE_GRAPHICS
+#include "graphics.h" // graphicsGlyphCacheFree
+#endif
 #ifdef BLUETOOTH
 #include "bluetooth.h"
 #include "jswrap_bluetooth.h"
@@ -924,6 +927,10 @@ bool jsiFreeMoreMemory() {
 #ifdef USE_DEBUGGER
   // remove debug history first
   jsvObjectRemoveChild(execInfo.hiddenRoot, JSI_DEBUG_HISTORY_NAME);
+#endif
+#ifdef GRAPHICS_GLYPH_CACHE
+  // the glyph cache can be recreated when needed
+  if (graphicsGlyphCacheFree()) return true;
 #endif
   // delete history one item at a time
   JsVar *history = jsvObjectGetChild(execInfo.hiddenRoot, JSI_HISTORY_NAME, 0);
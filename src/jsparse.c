@@ -1729,19 +1729,194 @@ NO_INLINE JsVar *jspeFactor() {
   return 0;
 }
 
+/** Get the value of 'v' (or of what the name 'v' points to) if it's a plain
+ * int or float, without locking or allocating anything. Returns false if it's
+ * anything else (so should go through jsvMathsOp). */
+static ALWAYS_INLINE bool jspeGetNumericValue(JsVar *v, JsVarInt *i, JsVarFloat *f, bool *isFloat) {
+  if (!v) return false;
+  if (jsvIsName(v)) {
+    if (jsvIsNameInt(v)) {
+      *i = (JsVarInt)jsvGetFirstChildSigned(v);
+      *isFloat = false;
+      return true;
+    }
+    if (jsvIsNameFloat(v)) {
+      *f = jsvGetFloatFromName(v);
+      *isFloat = true;
+      return true;
+    }
+    if (jsvIsNameWithValue(v) || jsvIsArrayBufferName(v) || !jsvGetFirstChild(v))
+      return false;
+    v = _jsvGetAddressOf(jsvGetFirstChild(v));
+  }
+  if (jsvIsSimpleInt(v)) {
+    *i = v->varData.integer;
+    *isFloat = false;
+    return true;
+  }
+  if (jsvIsFloat(v)) {
+    *f = v->varData.floating;
+    *isFloat = true;
+    return true;
+  }
+  return false;
+}
+
+/** Do an arithmetic/bitwise 'op' on two numbers the same way jsvMathsOp does.
+ * If the result is an int it's put in 'ri' (which may be out of JsVarInt range,
+ * in which case it should become a float), otherwise in 'rf'. Returns false
+ * for ops that aren't handled here. */
+static bool jspeNumericArith(int op,
+    bool aFloat, JsVarInt ia, JsVarFloat fa,
+    bool bFloat, JsVarInt ib, JsVarFloat fb,
+    bool *rFloat, long long *ri, JsVarFloat *rf) {
+  if (!aFloat && !bFloat) {
+    *rFloat = false;
+    switch (op) {
+    case '+': *ri = (long long)ia + (long long)ib; return true;
+    case '-': *ri = (long long)ia - (long long)ib; return true;
+    case '*': *ri = (long long)ia * (long long)ib; return true;
+    case '/': *rFloat = true; *rf = (JsVarFloat)ia/(JsVarFloat)ib; return true;
+    case '%': if (ib) *ri = ia%ib; else { *rFloat = true; *rf = NAN; } return true;
+    case '&': *ri = ia&ib; return true;
+    case '|': *ri = ia|ib; return true;
+    case '^': *ri = ia^ib; return true;
+    case LEX_LSHIFT: *ri = (JsVarInt)(ia << ib); return true;
+    case LEX_RSHIFT: *ri = ia >> ib; return true;
+    case LEX_RSHIFTUNSIGNED: *ri = (JsVarInt)(((JsVarIntUnsigned)ia) >> ib); return true;
+    default: return false;
+    }
+  }
+  if (!aFloat) fa = (JsVarFloat)ia;
+  if (!bFloat) fb = (JsVarFloat)ib;
+  *rFloat = true;
+  switch (op) {
+  case '+': *rf = fa+fb; return true;
+  case '-': *rf = fa-fb; return true;
+  case '*': *rf = fa*fb; return true;
+  case '/': *rf = fa/fb; return true;
+  default: return false; // '%' and bitwise ops on floats
+  }
+}
+
+/** Fast path for jsvMathsOpSkipNames when both sides are plain ints or floats.
+ * Results must match jsvMathsOp exactly. Returns false if it couldn't be
+ * done here, in which case 'res' is untouched. */
+static bool jspeMathsOpNumeric(JsVar *a, JsVar *b, int op, JsVar **res) {
+  JsVarInt ia, ib;
+  JsVarFloat fa, fb;
+  bool aFloat, bFloat;
+  if (!jspeGetNumericValue(a, &ia, &fa, &aFloat) ||
+      !jspeGetNumericValue(b, &ib, &fb, &bFloat))
+    return false;
+  bool rFloat;
+  long long ri;
+  JsVarFloat rf;
+  if (jspeNumericArith(op, aFloat, ia, fa, bFloat, ib, fb, &rFloat, &ri, &rf)) {
+    *res = rFloat ? jsvNewFromFloat(rf) : jsvNewFromLongInteger(ri);
+    return true;
+  }
+  if (!aFloat && !bFloat) {
+    switch (op) {
+    case LEX_EQUAL:
+    case LEX_TYPEEQUAL: *res = jsvNewFromBool(ia==ib); return true;
+    case LEX_NEQUAL:
+    case LEX_NTYPEEQUAL: *res = jsvNewFromBool(ia!=ib); return true;
+    case '<': *res = jsvNewFromBool(ia<ib); return true;
+    case LEX_LEQUAL: *res = jsvNewFromBool(ia<=ib); return true;
+    case '>': *res = jsvNewFromBool(ia>ib); return true;
+    case LEX_GEQUAL: *res = jsvNewFromBool(ia>=ib); return true;
+    default: return false;
+    }
+  }
+  if (!aFloat) fa = (JsVarFloat)ia;
+  if (!bFloat) fb = (JsVarFloat)ib;
+  switch (op) {
+  case LEX_EQUAL:
+  case LEX_TYPEEQUAL: *res = jsvNewFromBool(fa==fb); return true;
+  case LEX_NEQUAL:
+  case LEX_NTYPEEQUAL: *res = jsvNewFromBool(fa!=fb); return true;
+  case '<': *res = jsvNewFromBool(fa<fb); return true;
+  case LEX_LEQUAL: *res = jsvNewFromBool(fa<=fb); return true;
+  case '>': *res = jsvNewFromBool(fa>fb); return true;
+  case LEX_GEQUAL: *res = jsvNewFromBool(fa>=fb); return true;
+  default: return false;
+  }
+}
+
+/** Do 'a = a op b' by changing the number stored in name 'a' directly, rather
+ * than allocating a new JsVar and relinking the name. This works if the value
+ * is stored in the name itself (NAME_INT_INT/etc), or if the name links to an
+ * int or float that nothing else references and the result is the same type.
+ * 'a' must already be linked into its parent - NewChild names (eg. a value
+ * from a prototype) need jsvReplaceWith to add them to the object.
+ * Returns false if it couldn't be done - and then nothing has changed. */
+static bool jspeMathsOpInPlace(JsVar *a, int op, bool bFloat, JsVarInt ib, JsVarFloat fb) {
+  JsVarInt ia;
+  JsVarFloat fa;
+  bool aFloat;
+  if (!jsvIsName(a) || jsvIsNewChild(a) || !jsvGetRefs(a) ||
+      !jspeGetNumericValue(a, &ia, &fa, &aFloat))
+    return false;
+  bool rFloat;
+  long long ri;
+  JsVarFloat rf;
+  if (!jspeNumericArith(op, aFloat, ia, fa, bFloat, ib, fb, &rFloat, &ri, &rf))
+    return false;
+  bool riIsInt = ri>=-2147483648LL && ri<=2147483647LL;
+  if (jsvIsNameWithValue(a)) {
+    if (rFloat) return jsvSetNameWithValueFloat(a, rf);
+    return riIsInt && jsvSetNameWithValueInt(a, (JsVarInt)ri);
+  }
+  JsVar *v = _jsvGetAddressOf(jsvGetFirstChild(a));
+  if (jsvGetRefs(v)!=1 || jsvGetLocks(v)) return false; // shared
+  if (rFloat && jsvIsFloat(v)) {
+    v->varData.floating = rf;
+    return true;
+  }
+  if (!rFloat && riIsInt && jsvIsSimpleInt(v)) {
+    v->varData.integer = (JsVarInt)ri;
+    return true;
+  }
+  return false;
+}
+
+/** Fast path for ++/-- on a name holding a plain int or float. Updates 'a'
+ * (in place if possible) and returns true, or returns false if it couldn't
+ * be done here. If 'oldValue' is non-zero it's set to the value before. */
+static bool jspeIncDecNumeric(JsVar *a, int op, JsVar **oldValue) {
+  JsVarInt i;
+  JsVarFloat f;
+  bool isFloat;
+  if (!jsvIsName(a) || !jspeGetNumericValue(a, &i, &f, &isFloat))
+    return false;
+  if (oldValue)
+    *oldValue = isFloat ? jsvNewFromFloat(f) : jsvNewFromInteger(i);
+  int d = (op==LEX_PLUSPLUS) ? 1 : -1;
+  if (!jspeMathsOpInPlace(a, '+', false, d, 0)) {
+    JsVar *res = isFloat ? jsvNewFromFloat(f+d) : jsvNewFromLongInteger((long long)i+d);
+    jsvReplaceWith(a, res);
+    jsvUnLock(res);
+  }
+  return true;
+}
+
 NO_INLINE JsVar *__jspePostfixExpression(JsVar *a) {
   while (lex->tk==LEX_PLUSPLUS || lex->tk==LEX_MINUSMINUS) {
     int op = lex->tk;
     JSP_ASSERT_MATCH(op);
     if (JSP_SHOULD_EXECUTE) {
-      JsVar *one = jsvNewFromInteger(1);
-      JsVar *oldValue = jsvAsNumberAndUnLock(jsvSkipName(a)); // keep the old value (but convert to number)
-      JsVar *res = jsvMathsOpSkipNames(oldValue, one, op==LEX_PLUSPLUS ? '+' : '-');
-      jsvUnLock(one);
-
-      // in-place add/subtract
-      jsvReplaceWith(a, res);
-      jsvUnLock(res);
+      JsVar *oldValue;
+      if (!jspeIncDecNumeric(a, op, &oldValue)) {
+        JsVar *one = jsvNewFromInteger(1);
+        oldValue = jsvAsNumberAndUnLock(jsvSkipName(a)); // keep the old value (but convert to number)
+        JsVar *res = jsvMathsOpSkipNames(oldValue, one, op==LEX_PLUSPLUS ? '+' : '-');
+        jsvUnLock(one);
+
+        // in-place add/subtract
+        jsvReplaceWith(a, res);
+        jsvUnLock(res);
+      }
       // but then use the old value
       jsvUnLock(a);
       a = oldValue;
@@ -1757,7 +1932,7 @@ NO_INLINE JsVar *jspePostfixExpression() {
     int op = lex->tk;
     JSP_ASSERT_MATCH(op);
     a = jspePostfixExpression();
-    if (JSP_SHOULD_EXECUTE) {
+    if (JSP_SHOULD_EXECUTE && !jspeIncDecNumeric(a, op, 0)) {
       JsVar *one = jsvNewFromInteger(1);
       JsVar *res = jsvMathsOpSkipNames(a, one, op==LEX_PLUSPLUS ? '+' : '-');
       jsvUnLock(one);
@@ -1917,7 +2092,9 @@ NO_INLINE JsVar *__jspeBinaryExpression(JsVar *a, unsigned int lastPrecedence) {
           jsvUnLock3(av, bv, a);
           a = jsvNewFromBool(inst);
         } else {  // --------------------------------------------- NORMAL
-          JsVar *res = jsvMathsOpSkipNames(a, b, op);
+          JsVar *res;
+          if (!jspeMathsOpNumeric(a, b, op, &res))
+            res = jsvMathsOpSkipNames(a, b, op);
           jsvUnLock(a); a = res;
         }
       }
@@ -1968,6 +2145,57 @@ JsVar *jspeConditionalExpression() {
   return __jspeConditionalExpression(jspeBinaryExpression());
 }
 
+/** If 'name' points to a String that nothing else references, append 'value'
+ * to it directly rather than making a copy and appending to that. Returns
+ * true if the append was done. */
+static bool jspeAppendToStringInPlace(JsVar *name, JsVar *value) {
+  if (!jsvIsName(name)) return false;
+  JsVar *currentValue = jsvSkipName(name);
+  bool appended = false;
+  if (jsvIsBasicString(currentValue) && jsvGetRefs(currentValue)==1 &&
+      jsvGetLocks(currentValue)==1 && value!=currentValue) {
+    /* This is the only use of the string (nothing else has it referenced
+     * or locked) and we're not appending to ourselves, so we can do a
+     * simple append (rather than clone + append) */
+    JsVar *str = jsvAsString(value);
+    if (str) {
+      jsvAppendStringVarComplete(currentValue, str);
+      appended = true;
+    }
+    jsvUnLock(str);
+  }
+  jsvUnLock(currentValue);
+  return appended;
+}
+
+/** Parse the right hand side of 'lhs = ...'. If it's of the form 'lhs + b'
+ * (with nothing else after it) and lhs is a String, we can append to
+ * the String in place rather than copying it. */
+NO_INLINE JsVar *__jspeAssignmentExpression(JsVar *lhs);
+static NO_INLINE JsVar *jspeAssignmentRHS(JsVar *lhs) {
+  if (lex->tk!=LEX_ID || !JSP_SHOULD_EXECUTE || !jsvIsName(lhs))
+    return jspeAssignmentExpression();
+  JsVar *a = jspeUnaryExpression();
+  if (a==lhs && lex->tk=='+') {
+    JSP_ASSERT_MATCH('+');
+    JsVar *b = __jspeBinaryExpression(jspeUnaryExpression(),jspeGetBinaryExpressionPrecedence('+'));
+    JsVar *res = 0;
+    if (JSP_SHOULD_EXECUTE) {
+      JsVar *bv = jsvSkipName(b);
+      // only if nothing else could be executed between the append and the assignment
+      if (!jspeGetBinaryExpressionPrecedence(lex->tk) && lex->tk!='?' &&
+          jspeAppendToStringInPlace(lhs, bv))
+        res = jsvSkipName(lhs);
+      else
+        res = jsvMathsOpSkipNames(a, b, '+');
+      jsvUnLock(bv);
+    }
+    jsvUnLock2(a, b);
+    a = res;
+  }
+  return __jspeAssignmentExpression(__jspeConditionalExpression(__jspeBinaryExpression(a, 0)));
+}
+
 NO_INLINE JsVar *__jspeAssignmentExpression(JsVar *lhs) {
   if (lex->tk=='=' || lex->tk==LEX_PLUSEQUAL || lex->tk==LEX_MINUSEQUAL ||
       lex->tk==LEX_MULEQUAL || lex->tk==LEX_DIVEQUAL || lex->tk==LEX_MODEQUAL ||
@@ -1978,7 +2206,7 @@ NO_INLINE JsVar *__jspeAssignmentExpression(JsVar *lhs) {
 
     int op = lex->tk;
     JSP_ASSERT_MATCH(op);
-    rhs = jspeAssignmentExpression();
+    rhs = (op=='=') ? jspeAssignmentRHS(lhs) : jspeAssignmentExpression();
     rhs = jsvSkipNameAndUnLock(rhs); // ensure we get rid of any references on the RHS
 
     if (JSP_SHOULD_EXECUTE && lhs) {
@@ -1996,19 +2224,14 @@ NO_INLINE JsVar *__jspeAssignmentExpression(JsVar *lhs) {
         else if (op==LEX_RSHIFTEQUAL) op=LEX_RSHIFT;
         else if (op==LEX_LSHIFTEQUAL) op=LEX_LSHIFT;
         else if (op==LEX_RSHIFTUNSIGNEDEQUAL) op=LEX_RSHIFTUNSIGNED;
-        if (op=='+' && jsvIsName(lhs)) {
-          JsVar *currentValue = jsvSkipName(lhs);
-          if (jsvIsBasicString(currentValue) && jsvGetRefs(currentValue)==1 && rhs!=currentValue) {
-            /* A special case for string += where this is the only use of the string
-             * and we're not appending to ourselves. In this case we can do a
-             * simple append (rather than clone + append)*/
-            JsVar *str = jsvAsString(rhs);
-            jsvAppendStringVarComplete(currentValue, str);
-            jsvUnLock(str);
-            op = 0;
-          }
-          jsvUnLock(currentValue);
-        }
+        if (op=='+' && jspeAppendToStringInPlace(lhs, rhs))
+          op = 0;
+        JsVarInt ib;
+        JsVarFloat fb;
+        bool bFloat;
+        if (op && jspeGetNumericValue(rhs, &ib, &fb, &bFloat) &&
+            jspeMathsOpInPlace(lhs, op, bFloat, ib, fb))
+          op = 0;
         if (op) {
           /* Fallback which does a proper add */
           JsVar *res = jsvMathsOpSkipNames(lhs,rhs,op);
@@ -21,6 +21,7 @@
 #include "jswrap_object.h" // for jswrap_object_toString
 #include "jswrap_arraybuffer.h" // for jsvNewTypedArray
 #include "jswrap_dataview.h" // for jsvNewDataViewWithData
+#include <float.h> // for FLT_MAX
 
 #ifdef DEBUG
   /** When freeing, clear the references (nextChild/etc) in the JsVar.
@@ -61,13 +62,54 @@ volatile bool touchedFreeList = false;
 volatile JsVarRef jsVarFirstEmpty; ///< reference of first unused variable (variables are in a linked list)
 volatile MemBusyType isMemoryBusy; ///< Are we doing garbage collection or similar, so can't access memory?
 
+#ifndef SAVE_ON_FLASH
+/** Appending to a long String means walking the whole chain of STRING_EXTs
+ * to find the end. To make repeated appends fast we remember the last block
+ * of the Strings we most recently went to the end of, along with the number
+ * of characters before it. If the String has grown since, we only have to walk
+ * the new blocks. Entries are removed when any block they reference is freed. */
+#define JSV_STRING_TAIL_CACHE_SIZE 4
+typedef struct {
+  JsVarRef str;       ///< The String (or 0 if unused)
+  JsVarRef last;      ///< The last block of the String when it was cached
+  size_t charsBefore; ///< The number of characters in the String before 'last'
+} JsvStringTailCacheEntry;
+static JsvStringTailCacheEntry jsvStringTailCache[JSV_STRING_TAIL_CACHE_SIZE];
+static unsigned char jsvStringTailCacheNext; ///< next entry to replace
+
+/// Remove all entries from the String tail cache (eg. when vars are moved around)
+static void jsvStringTailCacheClear() {
+  memset(jsvStringTailCache, 0, sizeof(jsvStringTailCache));
+}
+
+/// The given var is being freed - remove it from the String tail cache
+static ALWAYS_INLINE void jsvStringTailCacheRemove(JsVarRef ref) {
+  int i;
+  for (i=0;i<JSV_STRING_TAIL_CACHE_SIZE;i++)
+    if (jsvStringTailCache[i].str==ref || jsvStringTailCache[i].last==ref)
+      jsvStringTailCache[i].str = jsvStringTailCache[i].last = 0;
+}
+
+/// Find the String tail cache entry for the given String, or 0
+static JsvStringTailCacheEntry *jsvStringTailCacheFind(JsVarRef ref) {
+  int i;
+  for (i=0;i<JSV_STRING_TAIL_CACHE_SIZE;i++)
+    if (jsvStringTailCache[i].str==ref)
+      return &jsvStringTailCache[i];
+  return 0;
+}
+#else
+#define jsvStringTailCacheClear()
+#define jsvStringTailCacheRemove(ref)
+#endif
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
 bool jsvIsRoot(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)==JSV_ROOT; }
 bool jsvIsPin(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)==JSV_PIN; }
 bool jsvIsSimpleInt(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)==JSV_INTEGER; } // is just a very basic integer value
-bool jsvIsInt(const JsVar *v) { return v && ((v->flags&JSV_VARTYPEMASK)==JSV_INTEGER || (v->flags&JSV_VARTYPEMASK)==JSV_PIN || (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT || (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_INT || (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_BOOL); }
+bool jsvIsInt(const JsVar *v) { return v && ((v->flags&JSV_VARTYPEMASK)==JSV_INTEGER || (v->flags&JSV_VARTYPEMASK)==JSV_PIN || (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT || (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_INT || (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_BOOL || (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_FLOAT); }
 bool jsvIsFloat(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)==JSV_FLOAT; }
 bool jsvIsBoolean(const JsVar *v) { return v && ((v->flags&JSV_VARTYPEMASK)==JSV_BOOLEAN || (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_BOOL); }
 bool jsvIsString(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)>=_JSV_STRING_START && (v->flags&JSV_VARTYPEMASK)<=_JSV_STRING_END; } ///< String, or a NAME too
@@ -90,7 +132,7 @@ bool jsvIsObject(const JsVar *v) { return v && (((v->flags&JSV_VARTYPEMASK)==JSV
 bool jsvIsArray(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)==JSV_ARRAY; }
 bool jsvIsArrayBuffer(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)==JSV_ARRAYBUFFER; }
 bool jsvIsArrayBufferName(const JsVar *v) { return v && (v->flags&(JSV_VARTYPEMASK))==JSV_ARRAYBUFFERNAME; }
-bool jsvIsNative(const JsVar *v) { return v && (v->flags&JSV_NATIVE)!=0; }
+bool jsvIsNative(const JsVar *v) { return v && (v->flags&JSV_NATIVE)!=0 && !jsvIsArrayBuffer(v); } // on ArrayBuffers JSV_NATIVE means JSV_ARRAYBUFFER_READONLY
 bool jsvIsNativeFunction(const JsVar *v) { return v && (v->flags&(JSV_NATIVE|JSV_VARTYPEMASK))==(JSV_NATIVE|JSV_FUNCTION); }
 bool jsvIsUndefined(const JsVar *v) { return v==0; }
 bool jsvIsNull(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)==JSV_NULL; }
@@ -102,6 +144,7 @@ bool jsvIsNameWithValue(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)
 bool jsvIsNameInt(const JsVar *v) { return v && ((v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_INT || ((v->flags&JSV_VARTYPEMASK)>=JSV_NAME_STRING_INT_0 && (v->flags&JSV_VARTYPEMASK)<=JSV_NAME_STRING_INT_MAX)); }
 bool jsvIsNameIntInt(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_INT; }
 bool jsvIsNameIntBool(const JsVar *v) { return v && (v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_BOOL; }
+bool jsvIsNameFloat(const JsVar *v) { return v && ((v->flags&JSV_VARTYPEMASK)==JSV_NAME_INT_FLOAT || ((v->flags&JSV_VARTYPEMASK)>=JSV_NAME_STRING_FLOAT_0 && (v->flags&JSV_VARTYPEMASK)<=JSV_NAME_STRING_FLOAT_MAX)); }
 /// What happens when we access a variable that doesn't exist. We get a NAME where the next + previous siblings point to the object that may one day contain them
 bool jsvIsNewChild(const JsVar *v) { return jsvIsName(v) && jsvGetNextSibling(v) && jsvGetNextSibling(v)==jsvGetPrevSibling(v); }
 /// Returns true if v is a getter/setter
@@ -197,6 +240,7 @@ void jsvSetMaxVarsUsed(unsigned int size) {
 void jsvCreateEmptyVarList() {
   assert(!isMemoryBusy);
   isMemoryBusy = MEMBUSY_SYSTEM;
+  jsvStringTailCacheClear();
   jsVarFirstEmpty = 0;
   JsVar firstVar; // temporary var to simplify code in the loop below
   jsvSetNextSibling(&firstVar, 0);
@@ -421,12 +465,15 @@ size_t jsvGetCharactersInVar(const JsVar *v) {
     return (size_t)v->varData.nativeStr.len;
 
   assert(f >= JSV_NAME_STRING_INT_0);
-  assert((JSV_NAME_STRING_INT_0 < JSV_NAME_STRING_0) &&
+  assert((JSV_NAME_STRING_INT_0 < JSV_NAME_STRING_FLOAT_0) &&
+         (JSV_NAME_STRING_FLOAT_0 < JSV_NAME_STRING_0) &&
          (JSV_NAME_STRING_0 < JSV_STRING_0) &&
          (JSV_STRING_0 < JSV_STRING_EXT_0)); // this relies on ordering
   if (f<=JSV_NAME_STRING_MAX) {
     if (f<=JSV_NAME_STRING_INT_MAX)
       return f-JSV_NAME_STRING_INT_0;
+    else if (f<=JSV_NAME_STRING_FLOAT_MAX)
+      return f-JSV_NAME_STRING_FLOAT_0;
     else
       return f-JSV_NAME_STRING_0;
   } else {
@@ -443,13 +490,16 @@ void jsvSetCharactersInVar(JsVar *v, size_t chars) {
 
   JsVarFlags m = (JsVarFlags)(v->flags&~JSV_VARTYPEMASK);
   assert(f >= JSV_NAME_STRING_INT_0);
-  assert((JSV_NAME_STRING_INT_0 < JSV_NAME_STRING_0) &&
+  assert((JSV_NAME_STRING_INT_0 < JSV_NAME_STRING_FLOAT_0) &&
+         (JSV_NAME_STRING_FLOAT_0 < JSV_NAME_STRING_0) &&
          (JSV_NAME_STRING_0 < JSV_STRING_0) &&
          (JSV_STRING_0 < JSV_STRING_EXT_0)); // this relies on ordering
   if (f<=JSV_NAME_STRING_MAX) {
     assert(chars <= JSVAR_DATA_STRING_NAME_LEN);
     if (f<=JSV_NAME_STRING_INT_MAX)
       v->flags = (JsVarFlags)(m | (JSV_NAME_STRING_INT_0+chars));
+    else if (f<=JSV_NAME_STRING_FLOAT_MAX)
+      v->flags = (JsVarFlags)(m | (JSV_NAME_STRING_FLOAT_0+chars));
     else
       v->flags = (JsVarFlags)(m | (JSV_NAME_STRING_0+chars));
   } else {
@@ -541,6 +591,7 @@ static NO_INLINE void jsvFreePtrInternal(JsVar *var) {
   var->flags = JSV_UNUSED;
   // add this to our free list
   jshInterruptOff(); // to allow this to be used from an IRQ
+  jsvStringTailCacheRemove(jsvGetRef(var));
   jsvSetNextSibling(var, jsVarFirstEmpty);
   jsVarFirstEmpty = jsvGetRef(var);
   touchedFreeList = true;
@@ -1056,10 +1107,51 @@ JsVar *jsvNewArrayBufferFromString(JsVar *str, unsigned int lengthOrZero) {
   arr->varData.arraybuffer.type = ARRAYBUFFERVIEW_ARRAYBUFFER;
   assert(arr->varData.arraybuffer.byteOffset == 0);
   if (lengthOrZero==0) lengthOrZero = (unsigned int)jsvGetStringLength(str);
+  if (lengthOrZero>JSV_ARRAYBUFFER_MAX_LENGTH) lengthOrZero = JSV_ARRAYBUFFER_MAX_LENGTH; // don't wrap around
   arr->varData.arraybuffer.length = (unsigned short)lengthOrZero;
   return arr;
 }
 
+/* Floats stored in names (JSV_NAME_INT_FLOAT/JSV_NAME_STRING_FLOAT) are the
+ * top bits of a 32 bit float - as many as fit in a JsVarRef. We only do this
+ * if the value survives the trip exactly, so it's never rounded. */
+#if JSVARREF_SIZE>1 && !defined(SAVE_ON_FLASH)
+#define JSV_NAME_FLOAT_SHIFT (32-8*JSVARREF_SIZE)
+#endif
+
+/// If 'v' can be stored exactly in a name, set *ref and return true
+static bool jsvGetNameFloatRef(JsVarFloat v, JsVarRef *ref) {
+#ifdef JSV_NAME_FLOAT_SHIFT
+  if (!(v>=-FLT_MAX && v<=FLT_MAX)) return false; // out of range, or NaN
+  float f = (float)v;
+  if ((JsVarFloat)f != v) return false; // would lose precision
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  if (bits & ((1UL<<JSV_NAME_FLOAT_SHIFT)-1)) return false; // doesn't fit in a JsVarRef
+  bits >>= JSV_NAME_FLOAT_SHIFT;
+  if (!bits) return false; // 0 should be an int anyway, and firstChild==0 means 'no value'
+  *ref = (JsVarRef)bits;
+  return true;
+#else
+  NOT_USED(v);
+  NOT_USED(ref);
+  return false;
+#endif
+}
+
+JsVarFloat jsvGetFloatFromName(const JsVar *name) {
+  assert(jsvIsNameFloat(name));
+#ifdef JSV_NAME_FLOAT_SHIFT
+  uint32_t bits = ((uint32_t)jsvGetFirstChild(name)) << JSV_NAME_FLOAT_SHIFT;
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return (JsVarFloat)f;
+#else
+  NOT_USED(name);
+  return NAN;
+#endif
+}
+
 JsVar *jsvMakeIntoVariableName(JsVar *var, JsVar *valueOrZero) {
   if (!var) return 0;
   assert(jsvGetRefs(var)==0); // make sure it's unused
@@ -1067,6 +1159,7 @@ JsVar *jsvMakeIntoVariableName(JsVar *var, JsVar *valueOrZero) {
   JsVarFlags varType = (var->flags & JSV_VARTYPEMASK);
   if (varType==JSV_INTEGER) {
     int t = JSV_NAME_INT;
+    JsVarRef floatRef;
     if ((jsvIsInt(valueOrZero) || jsvIsBoolean(valueOrZero)) && !jsvIsPin(valueOrZero)) {
       JsVarInt v = valueOrZero->varData.integer;
       if (v>=JSVARREF_MIN && v<=JSVARREF_MAX) {
@@ -1074,6 +1167,10 @@ JsVar *jsvMakeIntoVariableName(JsVar *var, JsVar *valueOrZero) {
         jsvSetFirstChild(var, (JsVarRef)v);
         valueOrZero = 0;
       }
+    } else if (jsvIsFloat(valueOrZero) && jsvGetNameFloatRef(valueOrZero->varData.floating, &floatRef)) {
+      t = JSV_NAME_INT_FLOAT;
+      jsvSetFirstChild(var, floatRef);
+      valueOrZero = 0;
     }
     var->flags = (JsVarFlags)(var->flags & ~JSV_VARTYPEMASK) | t;
   } else if (varType>=_JSV_STRING_START && varType<=_JSV_STRING_END) {
@@ -1122,6 +1219,7 @@ JsVar *jsvMakeIntoVariableName(JsVar *var, JsVar *valueOrZero) {
     }
 
     size_t t = JSV_NAME_STRING_0;
+    JsVarRef floatRef;
     if (jsvIsInt(valueOrZero) && !jsvIsPin(valueOrZero)) {
       JsVarInt v = valueOrZero->varData.integer;
       if (v>=JSVARREF_MIN && v<=JSVARREF_MAX) {
@@ -1129,6 +1227,10 @@ JsVar *jsvMakeIntoVariableName(JsVar *var, JsVar *valueOrZero) {
         jsvSetFirstChild(var, (JsVarRef)v);
         valueOrZero = 0;
       }
+    } else if (jsvIsFloat(valueOrZero) && jsvGetNameFloatRef(valueOrZero->varData.floating, &floatRef)) {
+      t = JSV_NAME_STRING_FLOAT_0;
+      jsvSetFirstChild(var, floatRef);
+      valueOrZero = 0;
     } else
       jsvSetFirstChild(var, 0);
     var->flags = (var->flags & (JsVarFlags)~JSV_VARTYPEMASK) | (t+jsvGetCharactersInVar(var));
@@ -1489,6 +1591,15 @@ size_t jsvGetStringLength(const JsVar *v) {
   const JsVar *var = v;
   JsVar *newVar = 0;
   if (!jsvHasCharacterData(v)) return 0;
+#ifndef SAVE_ON_FLASH
+  if (jsvGetLastChild(v) && jsvIsString(v)) {
+    // Long string - use the last block (which may be cached)
+    JsVar *last = jsvGetStringLastBlock((JsVar*)v, &strLength);
+    strLength += jsvGetCharactersInVar(last);
+    jsvUnLock(last);
+    return strLength;
+  }
+#endif
 
   while (var) {
     JsVarRef ref = jsvGetLastChild(var);
@@ -1502,6 +1613,61 @@ size_t jsvGetStringLength(const JsVar *v) {
   return strLength;
 }
 
+/** Get the last block of a String (locked), and the number of characters
+ * that come before it. For long Strings that we've recently been to the end
+ * of, this doesn't need to walk the whole chain of STRING_EXTs. */
+JsVar *jsvGetStringLastBlock(JsVar *v, size_t *charsBefore) {
+  *charsBefore = 0;
+  JsVarRef ref = jsvGetLastChild(v);
+  if (!ref) return jsvLockAgain(v);
+  JsVar *var = jsvLockAgain(v);
+#ifndef SAVE_ON_FLASH
+  JsVarRef strRef = jsvGetRef(v);
+  JsvStringTailCacheEntry *entry = jsvStringTailCacheFind(strRef);
+  if (entry) { // start from where we were last time
+    jsvUnLock(var);
+    var = jsvLock(entry->last);
+    *charsBefore = entry->charsBefore;
+    ref = jsvGetLastChild(var);
+  }
+#endif
+  while (ref) {
+    *charsBefore += jsvGetCharactersInVar(var);
+    jsvUnLock(var);
+    var = jsvLock(ref);
+    ref = jsvGetLastChild(var);
+  }
+#ifndef SAVE_ON_FLASH
+  if (!entry) {
+    entry = &jsvStringTailCache[jsvStringTailCacheNext];
+    jsvStringTailCacheNext = (unsigned char)((jsvStringTailCacheNext+1) % JSV_STRING_TAIL_CACHE_SIZE);
+    entry->str = strRef;
+  }
+  entry->last = jsvGetRef(var);
+  entry->charsBefore = *charsBefore;
+#endif
+  return var;
+}
+
+/** If we know where the end of this String is, return the (locked) block
+ * we know about that contains or is before character 'idx', and set
+ * charsBefore to the number of characters before it. Otherwise return 0.
+ * This doesn't walk the String, so is fast enough to call on every access. */
+JsVar *jsvGetStringCachedBlock(JsVar *v, size_t idx, size_t *charsBefore) {
+#ifndef SAVE_ON_FLASH
+  JsvStringTailCacheEntry *entry = jsvStringTailCacheFind(jsvGetRef(v));
+  if (entry && entry->charsBefore<=idx) {
+    *charsBefore = entry->charsBefore;
+    return jsvLock(entry->last);
+  }
+#else
+  NOT_USED(v);
+  NOT_USED(idx);
+  NOT_USED(charsBefore);
+#endif
+  return 0;
+}
+
 size_t jsvGetFlatStringBlocks(const JsVar *v) {
   assert(jsvIsFlatString(v));
   return ((size_t)v->varData.integer+sizeof(JsVar)-1) / sizeof(JsVar);
@@ -2103,6 +2269,20 @@ JsVar *jsvGetArrayBufferBackingString(JsVar *arrayBuffer) {
   return arrayBuffer;
 }
 
+/// Is this ArrayBuffer (or any ArrayBuffer it is based on) read-only? See JSV_ARRAYBUFFER_READONLY
+bool jsvIsArrayBufferReadOnly(JsVar *arrayBuffer) {
+  bool readOnly = false;
+  jsvLockAgain(arrayBuffer);
+  while (jsvIsArrayBuffer(arrayBuffer) && !readOnly) {
+    readOnly = (arrayBuffer->flags & JSV_ARRAYBUFFER_READONLY)!=0;
+    JsVar *s = jsvLock(jsvGetFirstChild(arrayBuffer));
+    jsvUnLock(arrayBuffer);
+    arrayBuffer = s;
+  }
+  jsvUnLock(arrayBuffer);
+  return readOnly;
+}
+
 /** Get the item at the given location in the array buffer and return the result */
 JsVar *jsvArrayBufferGet(JsVar *arrayBuffer, size_t idx) {
   JsvArrayBufferIterator it;
@@ -2169,6 +2349,7 @@ JsVar *jsvGetValueOfName(JsVar *a) {
   if (jsvIsArrayBufferName(a)) return jsvArrayBufferGetFromName(a);
   if (jsvIsNameInt(a)) return jsvNewFromInteger((JsVarInt)jsvGetFirstChildSigned(a));
   if (jsvIsNameIntBool(a)) return jsvNewFromBool(jsvGetFirstChild(a)!=0);
+  if (jsvIsNameFloat(a)) return jsvNewFromFloat(jsvGetFloatFromName(a));
   assert(!jsvIsNameWithValue(a));
   if (jsvIsName(a))
     return jsvLockSafe(jsvGetFirstChild(a));
@@ -2194,6 +2375,7 @@ JsVar *jsvSkipNameWithParent(JsVar *a, bool repeat, JsVar *parent) {
   if (jsvIsArrayBufferName(a)) return jsvArrayBufferGetFromName(a);
   if (jsvIsNameInt(a)) return jsvNewFromInteger((JsVarInt)jsvGetFirstChildSigned(a));
   if (jsvIsNameIntBool(a)) return jsvNewFromBool(jsvGetFirstChild(a)!=0);
+  if (jsvIsNameFloat(a)) return jsvNewFromFloat(jsvGetFloatFromName(a));
   JsVar *pa = jsvLockAgain(a);
   while (jsvIsName(pa)) {
     JsVarRef n = jsvGetFirstChild(pa);
@@ -2621,6 +2803,7 @@ JsVar *jsvSetValueOfName(JsVar *name, JsVar *src) {
   } else if (jsvGetFirstChild(name))
     jsvUnRefRef(jsvGetFirstChild(name)); // free existing
   if (src) {
+    JsVarRef floatRef;
     if (jsvIsInt(name)) {
       if ((jsvIsInt(src) || jsvIsBoolean(src)) && !jsvIsPin(src)) {
         JsVarInt v = src->varData.integer;
@@ -2629,6 +2812,10 @@ JsVar *jsvSetValueOfName(JsVar *name, JsVar *src) {
           jsvSetFirstChild(name, (JsVarRef)v);
           return name;
         }
+      } else if (jsvIsFloat(src) && jsvGetNameFloatRef(src->varData.floating, &floatRef)) {
+        name->flags = (name->flags & (JsVarFlags)~JSV_VARTYPEMASK) | JSV_NAME_INT_FLOAT;
+        jsvSetFirstChild(name, floatRef);
+        return name;
       }
     } else if (jsvIsString(name)) {
       if (jsvIsInt(src) && !jsvIsPin(src)) {
@@ -2638,6 +2825,10 @@ JsVar *jsvSetValueOfName(JsVar *name, JsVar *src) {
           jsvSetFirstChild(name, (JsVarRef)v);
           return name;
         }
+      } else if (jsvIsFloat(src) && jsvGetNameFloatRef(src->varData.floating, &floatRef)) {
+        name->flags = (name->flags & (JsVarFlags)~JSV_VARTYPEMASK) | (JSV_NAME_STRING_FLOAT_0 + jsvGetCharactersInVar(name));
+        jsvSetFirstChild(name, floatRef);
+        return name;
       }
     }
     // we can link to a name if we want (so can remove the assert!)
@@ -2647,6 +2838,33 @@ JsVar *jsvSetValueOfName(JsVar *name, JsVar *src) {
   return name;
 }
 
+bool jsvSetNameWithValueInt(JsVar *name, JsVarInt value) {
+  if (!jsvIsNameWithValue(name))
+    return false;
+#if JSVARREF_SIZE<4 // with 32 bit refs any JsVarInt fits
+  if (value<JSVARREF_MIN || value>JSVARREF_MAX)
+    return false;
+#endif
+  if (jsvIsString(name))
+    name->flags = (name->flags & (JsVarFlags)~JSV_VARTYPEMASK) | (JSV_NAME_STRING_INT_0 + jsvGetCharactersInVar(name));
+  else
+    name->flags = (name->flags & (JsVarFlags)~JSV_VARTYPEMASK) | JSV_NAME_INT_INT;
+  jsvSetFirstChild(name, (JsVarRef)value);
+  return true;
+}
+
+bool jsvSetNameWithValueFloat(JsVar *name, JsVarFloat value) {
+  JsVarRef floatRef;
+  if (!jsvIsNameWithValue(name) || !jsvGetNameFloatRef(value, &floatRef))
+    return false;
+  if (jsvIsString(name))
+    name->flags = (name->flags & (JsVarFlags)~JSV_VARTYPEMASK) | (JSV_NAME_STRING_FLOAT_0 + jsvGetCharactersInVar(name));
+  else
+    name->flags = (name->flags & (JsVarFlags)~JSV_VARTYPEMASK) | JSV_NAME_INT_FLOAT;
+  jsvSetFirstChild(name, floatRef);
+  return true;
+}
+
 JsVar *jsvFindChildFromString(JsVar *parent, const char *name, bool addIfNotFound) {
   /* Pull out first 4 bytes, and ensure that everything
    * is 0 padded so that we can do a nice speedy check. */
@@ -3671,6 +3889,9 @@ void _jsvTrace(JsVar *var, int indent, JsVar *baseVar, int level) {
   } else if (jsvIsNameIntBool(var)) {
     jsiConsolePrintf("= bool %s\n", jsvGetFirstChild(var)?"true":"false");
     return;
+  } else if (jsvIsNameFloat(var)) {
+    jsiConsolePrintf("= float %f\n", jsvGetFloatFromName(var));
+    return;
   }
 
   if (jsvHasSingleChild(var)) {
@@ -3746,6 +3967,7 @@ static void jsvGarbageCollectMarkUsed(JsVar *var) {
 int jsvGarbageCollect() {
   if (isMemoryBusy) return false;
   isMemoryBusy = MEMBUSY_GC;
+  jsvStringTailCacheClear(); // we may free any of the cached blocks
   JsVarRef i;
   // Add GC flags to anything that is currently used
   for (i=1;i<=jsVarsSize;i++)  {
@@ -3859,6 +4081,7 @@ void jsvDefragment() {
   // garbage collect - removes cruft
   // also puts free list in order
   jsvGarbageCollect();
+  jsvStringTailCacheClear(); // vars are about to move
   // Fill defragVars with defraggable variables
   jshInterruptOff();
   const int DEFRAGVARS = 256; // POWER OF 2
@@ -53,13 +53,16 @@ typedef enum {
     JSV_NAME_INT_INT    = JSV_NAME_INT+1, ///< integer array/object index WITH integer value
   _JSV_NAME_WITH_VALUE_START = JSV_NAME_INT_INT, ///< ---------- Start of names that have literal values, NOT references, in firstChild
     JSV_NAME_INT_BOOL    = JSV_NAME_INT_INT+1, ///< integer array/object index WITH boolean value
-  _JSV_NAME_INT_END = JSV_NAME_INT_BOOL,
-  _JSV_NUMERIC_END  = JSV_NAME_INT_BOOL, ///< --------- End of numeric variable types
-    JSV_NAME_STRING_INT_0    = JSV_NAME_INT_BOOL+1, // array/object index as string of length 0 WITH integer value
+    JSV_NAME_INT_FLOAT   = JSV_NAME_INT_BOOL+1, ///< integer array/object index WITH float value (see jsvGetFloatFromName)
+  _JSV_NAME_INT_END = JSV_NAME_INT_FLOAT,
+  _JSV_NUMERIC_END  = JSV_NAME_INT_FLOAT, ///< --------- End of numeric variable types
+    JSV_NAME_STRING_INT_0    = JSV_NAME_INT_FLOAT+1, // array/object index as string of length 0 WITH integer value
   _JSV_STRING_START =  JSV_NAME_STRING_INT_0,
     JSV_NAME_STRING_INT_MAX  = JSV_NAME_STRING_INT_0+JSVAR_DATA_STRING_NAME_LEN,
-  _JSV_NAME_WITH_VALUE_END = JSV_NAME_STRING_INT_MAX, ///< ---------- End of names that have literal values, NOT references, in firstChild
-    JSV_NAME_STRING_0    = JSV_NAME_STRING_INT_MAX+1, // array/object index as string of length 0
+    JSV_NAME_STRING_FLOAT_0    = JSV_NAME_STRING_INT_MAX+1, // array/object index as string of length 0 WITH float value
+    JSV_NAME_STRING_FLOAT_MAX  = JSV_NAME_STRING_FLOAT_0+JSVAR_DATA_STRING_NAME_LEN,
+  _JSV_NAME_WITH_VALUE_END = JSV_NAME_STRING_FLOAT_MAX, ///< ---------- End of names that have literal values, NOT references, in firstChild
+    JSV_NAME_STRING_0    = JSV_NAME_STRING_FLOAT_MAX+1, // array/object index as string of length 0
     JSV_NAME_STRING_MAX  = JSV_NAME_STRING_0+JSVAR_DATA_STRING_NAME_LEN,
   _JSV_NAME_END    = JSV_NAME_STRING_MAX, ///< ---------- End of NAMEs (names of variables, object fields/etc)
     JSV_STRING_0    = JSV_NAME_STRING_MAX+1, // simple string value of length 0
@@ -76,9 +79,9 @@ typedef enum {
     JSV_STRING_EXT_MAX = JSV_STRING_EXT_0+JSVAR_DATA_STRING_MAX_LEN,
     _JSV_VAR_END     = JSV_STRING_EXT_MAX, ///< End of variable types
     // _JSV_VAR_END is:
-    //     39 on systems with 8 bit JsVarRefs
-    //     43 on systems with 16 bit JsVarRefs
-    //     51 on systems with 32 bit JsVarRefs (more if on a 64 bit platform though)
+    //     45 on systems with 8 bit JsVarRefs
+    //     49 on systems with 16 bit JsVarRefs
+    //     57 on systems with 32 bit JsVarRefs (more if on a 64 bit platform though)
 
     JSV_VARTYPEMASK = NEXT_POWER_2(_JSV_VAR_END)-1, // probably this is 63
 
@@ -129,6 +132,7 @@ typedef enum {
 #define JSV_ARRAYBUFFER_IS_CLAMPED(T) (((T)&ARRAYBUFFERVIEW_CLAMPED)!=0)
 
 #define JSV_ARRAYBUFFER_MAX_LENGTH 65535
+#define JSV_ARRAYBUFFER_READONLY JSV_NATIVE ///< Flag set on an ArrayBuffer whose data mustn't be written (eg. it's in flash). jsvIsNative ignores it
 
 typedef struct {
   unsigned short byteOffset;
@@ -265,6 +269,7 @@ typedef struct {
 
  * NAME_INT_INT/NAME_INT_BOOL are the same as NAME_INT, except 'child' contains the value rather than a pointer
  * NAME_STRING_INT is the same as NAME_STRING, except 'child' contains the value rather than a pointer
+ * NAME_INT_FLOAT/NAME_STRING_FLOAT store the top bits of a 32 bit float in 'child' - only used when the value is exact
  * FLAT_STRING uses the variable blocks that follow it as flat storage for all the data
  * NATIVE_FUNCTION's nativePtr is a pointer to code if there is no child called JSPARSE_FUNCTION_CODE_NAME, but if there is one, it's an index into that child
  *
@@ -426,6 +431,7 @@ extern bool jsvIsNameWithValue(const JsVar *v);
 extern bool jsvIsNameInt(const JsVar *v);
 extern bool jsvIsNameIntInt(const JsVar *v);
 extern bool jsvIsNameIntBool(const JsVar *v);
+extern bool jsvIsNameFloat(const JsVar *v); ///< Name with a float value stored in it
 /// What happens when we access a variable that doesn't exist. We get a NAME where the next + previous siblings point to the object that may one day contain them
 extern bool jsvIsNewChild(const JsVar *v);
 /// Returns true if v is a getter/setter
@@ -493,6 +499,8 @@ JsVar *jsvAsStringAndUnLock(JsVar *var); ///< Same as jsvAsString, but unlocks '
 JsVar *jsvAsFlatString(JsVar *var); ///< Create a flat string from the given variable (or return it if it is already a flat string). NOTE: THIS CONVERTS VIA A STRING
 bool jsvIsEmptyString(JsVar *v); ///< Returns true if the string is empty - faster than jsvGetStringLength(v)==0
 size_t jsvGetStringLength(const JsVar *v); ///< Get the length of this string, IF it is a string
+JsVar *jsvGetStringLastBlock(JsVar *v, size_t *charsBefore); ///< Get the last block of a string (locked) and the number of characters before it
+JsVar *jsvGetStringCachedBlock(JsVar *v, size_t idx, size_t *charsBefore); ///< If known, get a block (locked) of the string at or before char idx without walking the string - else 0
 size_t jsvGetFlatStringBlocks(const JsVar *v); ///< return the number of blocks used by the given flat string - EXCLUDING the first data block
 char *jsvGetFlatStringPointer(JsVar *v); ///< Get a pointer to the data in this flat string
 JsVar *jsvGetFlatStringFromPointer(char *v); ///< Given a pointer to the first element of a flat string, return the flat string itself (DANGEROUS!)
@@ -574,6 +582,8 @@ void jsvReplaceWithOrAddToRoot(JsVar *dst, JsVar *src);
 size_t jsvGetArrayBufferLength(const JsVar *arrayBuffer);
 /** Get the String the contains the data for this arrayBuffer. Is ok with being passed a String in the first place. */
 JsVar *jsvGetArrayBufferBackingString(JsVar *arrayBuffer);
+/// Is this ArrayBuffer (or any ArrayBuffer it is based on) read-only? See JSV_ARRAYBUFFER_READONLY
+bool jsvIsArrayBufferReadOnly(JsVar *arrayBuffer);
 /** Get the item at the given location in the array buffer and return the result */
 JsVar *jsvArrayBufferGet(JsVar *arrayBuffer, size_t index);
 /** Set the item at the given location in the array buffer */
@@ -594,6 +604,9 @@ bool jsvIsVariableDefined(JsVar *a);
  * return that var, else 0. */
 JsVar *jsvGetValueOfName(JsVar *name);
 
+/// Get the float value stored in a name for which jsvIsNameFloat is true
+JsVarFloat jsvGetFloatFromName(const JsVar *name);
+
 /* Check for and trigger a ReferenceError on a variable if it's a name that doesn't exist */
 void jsvCheckReferenceError(JsVar *a);
 
@@ -659,6 +672,10 @@ void jsvAddName(JsVar *parent, JsVar *nameChild); // Add a child, which is itsel
 JsVar *jsvAddNamedChild(JsVar *parent, JsVar *child, const char *name); // Add a child, and create a name for it. Returns a LOCKED var. DOES NOT CHECK FOR DUPLICATES
 JsVar *jsvSetNamedChild(JsVar *parent, JsVar *child, const char *name); // Add a child, and create a name for it. Returns a LOCKED name var. CHECKS FOR DUPLICATES
 JsVar *jsvSetValueOfName(JsVar *name, JsVar *src); // Set the value of a child created with jsvAddName,jsvAddNamedChild. Returns the UNLOCKED name argument
+/** If 'name' stores its value directly (jsvIsNameWithValue) and 'value' fits
+ * in it, set the value without allocating anything and return true */
+bool jsvSetNameWithValueInt(JsVar *name, JsVarInt value);
+bool jsvSetNameWithValueFloat(JsVar *name, JsVarFloat value); ///< see jsvSetNameWithValueInt
 JsVar *jsvFindChildFromString(JsVar *parent, const char *name, bool createIfNotFound); // Non-recursive finding of child with name. Returns a LOCKED var
 JsVar *jsvFindChildFromStringI(JsVar *parent, const char *name); ///< Find a child with a matching name using a case insensitive search
 JsVar *jsvFindChildFromVar(JsVar *parent, JsVar *childName, bool addIfNotFound); ///< Non-recursive finding of child with name. Returns a LOCKED var
@@ -270,6 +270,19 @@ void jsvStringIteratorNew(JsvStringIterator *it, JsVar *str, size_t startIdx) {
 #endif
   } else{
     it->ptr = &it->var->varData.str[0];
+    if (startIdx>=it->charsInVar && jsvGetLastChild(str)) {
+      // If we know about a block later on in the string, start from there
+      size_t charsBefore;
+      JsVar *block = jsvGetStringCachedBlock(str, startIdx, &charsBefore);
+      if (block) {
+        jsvUnLock(it->var);
+        it->var = block;
+        it->ptr = &block->varData.str[0];
+        it->varIndex = charsBefore;
+        it->charsInVar = jsvGetCharactersInVar(block);
+        it->charIdx = startIdx - charsBefore;
+      }
+    }
   }
   jsvStringIteratorCatchUp(it);
 }
@@ -317,6 +330,13 @@ void jsvStringIteratorGetPtrAndNext(JsvStringIterator *it, unsigned char **data,
 
 void jsvStringIteratorGotoEnd(JsvStringIterator *it) {
   assert(it->var);
+  if (it->varIndex==0 && jsvGetLastChild(it->var)) {
+    // We're at the start of the String - jump straight to the last block
+    JsVar *last = jsvGetStringLastBlock(it->var, &it->varIndex);
+    jsvUnLock(it->var);
+    it->var = last;
+    it->charsInVar = jsvGetCharactersInVar(it->var);
+  }
   while (jsvGetLastChild(it->var)) {
     JsVar *next = jsvLock(jsvGetLastChild(it->var));
     jsvUnLock(it->var);
@@ -427,6 +447,7 @@ void   jsvArrayBufferIteratorNew(JsvArrayBufferIterator *it, JsVar *arrayBuffer,
   it->type = arrayBuffer->varData.arraybuffer.type;
   it->byteLength = arrayBuffer->varData.arraybuffer.length * JSV_ARRAYBUFFER_GET_SIZE(it->type);
   it->byteOffset = arrayBuffer->varData.arraybuffer.byteOffset;
+  it->isReadOnly = jsvIsArrayBufferReadOnly(arrayBuffer);
   JsVar *arrayBufferData = jsvGetArrayBufferBackingString(arrayBuffer);
 
   it->byteLength += it->byteOffset; // because we'll check if we have more bytes using this
@@ -439,6 +460,14 @@ void   jsvArrayBufferIteratorNew(JsvArrayBufferIterator *it, JsVar *arrayBuffer,
   jsvStringIteratorNew(&it->it, arrayBufferData, (size_t)it->byteOffset);
   jsvUnLock(arrayBufferData);
   it->hasAccessedElement = false;
+  /* Flat, native and single-block strings have all their data in one place
+   * (flash strings are loaded a few bytes at a time so don't count) */
+  it->isContiguous = it->it.varIndex==0 && it->it.charsInVar>=it->byteLength;
+}
+
+/// Pointer to the current element's data, if the iterator isContiguous
+static ALWAYS_INLINE char *jsvArrayBufferIteratorGetDataPtr(JsvArrayBufferIterator *it) {
+  return &it->it.ptr[it->it.charIdx];
 }
 
 /// Clone the iterator
@@ -451,6 +480,16 @@ static void jsvArrayBufferIteratorGetValueData(JsvArrayBufferIterator *it, char
   if (it->type == ARRAYBUFFERVIEW_UNDEFINED) return;
   assert(!it->hasAccessedElement); // we just haven't implemented this case yet
   int i,dataLen = (int)JSV_ARRAYBUFFER_GET_SIZE(it->type);
+  if (it->isContiguous) {
+    // read straight out of memory, and leave the iterator where it is
+    char *ptr = jsvArrayBufferIteratorGetDataPtr(it);
+    if (it->type & ARRAYBUFFERVIEW_BIG_ENDIAN) {
+      for (i=0;i<dataLen;i++)
+        data[i] = ptr[dataLen-1-i];
+    } else
+      memcpy(data, ptr, (size_t)dataLen);
+    return;
+  }
   if (it->type & ARRAYBUFFERVIEW_BIG_ENDIAN) {
     for (i=dataLen-1;i>=0;i--) {
        data[i] = jsvStringIteratorGetChar(&it->it);
@@ -511,6 +550,19 @@ JsVar *jsvArrayBufferIteratorGetValueAndRewind(JsvArrayBufferIterator *it) {
 
 JsVarInt jsvArrayBufferIteratorGetIntegerValue(JsvArrayBufferIterator *it) {
   if (it->type == ARRAYBUFFERVIEW_UNDEFINED) return 0;
+  if (it->isContiguous) {
+    // fast path for the common little-endian types
+    char *ptr = jsvArrayBufferIteratorGetDataPtr(it);
+    switch (it->type & ~ARRAYBUFFERVIEW_CLAMPED) {
+      case ARRAYBUFFERVIEW_ARRAYBUFFER:
+      case ARRAYBUFFERVIEW_UINT8: return (uint8_t)*ptr;
+      case ARRAYBUFFERVIEW_INT8: return (int8_t)*ptr;
+      case ARRAYBUFFERVIEW_UINT16: { uint16_t v; memcpy(&v, ptr, sizeof(v)); return v; }
+      case ARRAYBUFFERVIEW_INT16: { int16_t v; memcpy(&v, ptr, sizeof(v)); return v; }
+      case ARRAYBUFFERVIEW_INT32: { int32_t v; memcpy(&v, ptr, sizeof(v)); return v; }
+      default: break;
+    }
+  }
   char data[8];
   jsvArrayBufferIteratorGetValueData(it, data);
   if (JSV_ARRAYBUFFER_IS_FLOAT(it->type)) {
@@ -527,7 +579,10 @@ JsVarFloat jsvArrayBufferIteratorGetFloatValue(JsvArrayBufferIterator *it) {
   if (JSV_ARRAYBUFFER_IS_FLOAT(it->type)) {
     return jsvArrayBufferIteratorDataToFloat(it, data);
   } else {
-    return (JsVarFloat)jsvArrayBufferIteratorDataToInt(it, data);
+    JsVarInt i = jsvArrayBufferIteratorDataToInt(it, data);
+    if ((it->type & ~ARRAYBUFFERVIEW_BIG_ENDIAN) == ARRAYBUFFERVIEW_UINT32)
+      return (JsVarFloat)(uint32_t)i;
+    return (JsVarFloat)i;
   }
 }
 
@@ -550,7 +605,7 @@ static void jsvArrayBufferIteratorFloatToData(char *data,  unsigned int dataLen,
 }
 
 void jsvArrayBufferIteratorSetIntegerValue(JsvArrayBufferIterator *it, JsVarInt v) {
-  if (it->type == ARRAYBUFFERVIEW_UNDEFINED) return;
+  if (it->type == ARRAYBUFFERVIEW_UNDEFINED || it->isReadOnly) return;
   assert(!it->hasAccessedElement); // we just haven't implemented this case yet
   char data[8];
   unsigned int i,dataLen = JSV_ARRAYBUFFER_GET_SIZE(it->type);
@@ -561,6 +616,10 @@ void jsvArrayBufferIteratorSetIntegerValue(JsvArrayBufferIterator *it, JsVarInt
     jsvArrayBufferIteratorIntToData(data, dataLen, it->type, v);
   }
 
+  if (it->isContiguous && !(it->type & ARRAYBUFFERVIEW_BIG_ENDIAN)) {
+    memcpy(jsvArrayBufferIteratorGetDataPtr(it), data, dataLen);
+    return;
+  }
   for (i=0;i<dataLen;i++) {
     jsvStringIteratorSetChar(&it->it, data[i]);
     if (dataLen!=1) jsvStringIteratorNext(&it->it);
@@ -568,18 +627,19 @@ void jsvArrayBufferIteratorSetIntegerValue(JsvArrayBufferIterator *it, JsVarInt
   if (dataLen!=1) it->hasAccessedElement = true;
 }
 
-void jsvArrayBufferIteratorSetValue(JsvArrayBufferIterator *it, JsVar *value) {
-  if (it->type == ARRAYBUFFERVIEW_UNDEFINED) return;
-  assert(!it->hasAccessedElement); // we just haven't implemented this case yet
-  char data[8];
+/// Write the data for one element (dataLen bytes, little endian) to the current position
+static void jsvArrayBufferIteratorSetValueData(JsvArrayBufferIterator *it, char *data) {
   int i,dataLen = (int)JSV_ARRAYBUFFER_GET_SIZE(it->type);
-
-  if (JSV_ARRAYBUFFER_IS_FLOAT(it->type)) {
-    jsvArrayBufferIteratorFloatToData(data, (unsigned)dataLen, it->type, jsvGetFloat(value));
-  } else {
-    jsvArrayBufferIteratorIntToData(data, (unsigned)dataLen, it->type, jsvGetInteger(value));
+  if (it->isContiguous) {
+    // write straight into memory, and leave the iterator where it is
+    char *ptr = jsvArrayBufferIteratorGetDataPtr(it);
+    if (it->type & ARRAYBUFFERVIEW_BIG_ENDIAN) {
+      for (i=0;i<dataLen;i++)
+        ptr[dataLen-1-i] = data[i];
+    } else
+      memcpy(ptr, data, (size_t)dataLen);
+    return;
   }
-
   if (it->type & ARRAYBUFFERVIEW_BIG_ENDIAN) {
     for (i=dataLen-1;i>=0;i--) {
       jsvStringIteratorSetChar(&it->it, data[i]);
@@ -594,7 +654,36 @@ void jsvArrayBufferIteratorSetValue(JsvArrayBufferIterator *it, JsVar *value) {
   if (dataLen!=1) it->hasAccessedElement = true;
 }
 
+void jsvArrayBufferIteratorSetValue(JsvArrayBufferIterator *it, JsVar *value) {
+  if (it->type == ARRAYBUFFERVIEW_UNDEFINED || it->isReadOnly) return;
+  assert(!it->hasAccessedElement); // we just haven't implemented this case yet
+  char data[8];
+  unsigned int dataLen = JSV_ARRAYBUFFER_GET_SIZE(it->type);
+
+  if (JSV_ARRAYBUFFER_IS_FLOAT(it->type)) {
+    jsvArrayBufferIteratorFloatToData(data, dataLen, it->type, jsvGetFloat(value));
+  } else {
+    jsvArrayBufferIteratorIntToData(data, dataLen, it->type, jsvGetInteger(value));
+  }
+  jsvArrayBufferIteratorSetValueData(it, data);
+}
+
+void jsvArrayBufferIteratorSetFloatValue(JsvArrayBufferIterator *it, JsVarFloat value) {
+  if (it->type == ARRAYBUFFERVIEW_UNDEFINED || it->isReadOnly) return;
+  assert(!it->hasAccessedElement); // we just haven't implemented this case yet
+  char data[8];
+  unsigned int dataLen = JSV_ARRAYBUFFER_GET_SIZE(it->type);
+
+  if (JSV_ARRAYBUFFER_IS_FLOAT(it->type)) {
+    jsvArrayBufferIteratorFloatToData(data, dataLen, it->type, value);
+  } else {
+    jsvArrayBufferIteratorIntToData(data, dataLen, it->type, isfinite(value) ? (JsVarInt)(long long)value : 0);
+  }
+  jsvArrayBufferIteratorSetValueData(it, data);
+}
+
 void jsvArrayBufferIteratorSetByteValue(JsvArrayBufferIterator *it, char c) {
+  if (it->isReadOnly) return;
   if (JSV_ARRAYBUFFER_GET_SIZE(it->type)!=1) {
     assert(0);
     return;
@@ -626,7 +715,9 @@ bool jsvArrayBufferIteratorHasElement(JsvArrayBufferIterator *it) {
 void   jsvArrayBufferIteratorNext(JsvArrayBufferIterator *it) {
   it->index++;
   it->byteOffset += JSV_ARRAYBUFFER_GET_SIZE(it->type);
-  if (!it->hasAccessedElement) {
+  if (it->isContiguous) {
+    it->it.charIdx += JSV_ARRAYBUFFER_GET_SIZE(it->type);
+  } else if (!it->hasAccessedElement) {
     unsigned int dataLen = JSV_ARRAYBUFFER_GET_SIZE(it->type);
     while (dataLen--)
       jsvStringIteratorNext(&it->it);
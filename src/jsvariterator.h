@@ -216,12 +216,10 @@ typedef struct JsvArrayBufferIterator {
   size_t byteOffset;
   size_t index;
   bool hasAccessedElement;
+  bool isContiguous; ///< all the data is in it.ptr, so we can access elements directly rather than a byte at a time
+  bool isReadOnly; ///< the data mustn't be written (eg. it's in flash), so writes are ignored
 } JsvArrayBufferIterator;
 
-/* TODO: can we add it->getIntegerValue/etc that get set by jsvArrayBufferIteratorNew?
-   It's be way faster, especially for byte arrays
-*/
-
 void   jsvArrayBufferIteratorNew(JsvArrayBufferIterator *it, JsVar *arrayBuffer, size_t index);
 
 /// Clone the iterator
@@ -237,6 +235,7 @@ JsVarFloat jsvArrayBufferIteratorGetFloatValue(JsvArrayBufferIterator *it);
 void   jsvArrayBufferIteratorSetValue(JsvArrayBufferIterator *it, JsVar *value);
 void   jsvArrayBufferIteratorSetValueAndRewind(JsvArrayBufferIterator *it, JsVar *value);
 void   jsvArrayBufferIteratorSetIntegerValue(JsvArrayBufferIterator *it, JsVarInt value);
+void   jsvArrayBufferIteratorSetFloatValue(JsvArrayBufferIterator *it, JsVarFloat value);
 void   jsvArrayBufferIteratorSetByteValue(JsvArrayBufferIterator *it, char c); ///< special case for when we know we're writing to a byte array
 JsVar* jsvArrayBufferIteratorGetIndex(JsvArrayBufferIterator *it);
 bool   jsvArrayBufferIteratorHasElement(JsvArrayBufferIterator *it);
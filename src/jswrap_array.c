@@ -228,6 +228,18 @@ typedef enum {
   RETURN_ARRAY_INDEX
 } AIWCReturnType;
 
+/** Get a JsVar holding 'idx' to pass to an iteration callback. If the var we
+passed last time wasn't kept by the callback (no references, nobody else has
+it locked) we just overwrite its value rather than allocating a new one. */
+static JsVar *_jswrap_array_iterate_index(JsVar *indexVar, JsVarInt idx) {
+  if (indexVar && jsvIsInt(indexVar) && !jsvGetRefs(indexVar) && jsvGetLocks(indexVar)==1) {
+    jsvSetInteger(indexVar, idx);
+    return indexVar;
+  }
+  jsvUnLock(indexVar);
+  return jsvNewFromInteger(idx);
+}
+
 /// General purpose looping function - re-use as much as possible
 static JsVar *_jswrap_array_iterate_with_callback(
     const char *name,  //< use this in error messages
@@ -251,10 +263,17 @@ static JsVar *_jswrap_array_iterate_with_callback(
     return 0;
   }
   JsVar *result = 0;
-  if (returnType == RETURN_ARRAY)
+  if (returnType == RETURN_ARRAY) {
     result = jsvNewEmptyArray();
+    // map keeps the length (and holes) of the original
+    if (result && !isBoolCallback && jsvIsArray(parent))
+      jsvSetArrayLength(result, jsvGetArrayLength(parent), false);
+  }
   bool isDone = false;
   if (result || returnType!=RETURN_ARRAY) {
+    JsVar *args[3], *cb_result;
+    args[1] = 0; // index - reused between calls if possible
+    args[2] = parent;
     JsvIterator it;
     jsvIteratorNew(&it, parent, JSIF_DEFINED_ARRAY_ElEMENTS);
     while (jsvIteratorHasElement(&it) && !isDone) {
@@ -262,12 +281,10 @@ static JsVar *_jswrap_array_iterate_with_callback(
       if (jsvIsInt(index)) {
         JsVarInt idxValue = jsvGetInteger(index);
 
-        JsVar *args[3], *cb_result;
         args[0] = jsvIteratorGetValue(&it);
-        args[1] = jsvNewFromInteger(idxValue); // child is a variable name, create a new variable for the index
-        args[2] = parent;
+        args[1] = _jswrap_array_iterate_index(args[1], idxValue);
         cb_result = jspeFunctionCall(funcVar, 0, thisVar, false, 3, args);
-        jsvUnLockMany(2,args);
+        jsvUnLock(args[0]);
         if (cb_result) {
           bool matched;
           if (isBoolCallback)
@@ -291,7 +308,7 @@ static JsVar *_jswrap_array_iterate_with_callback(
               if (matched) {
                 result = (returnType == RETURN_ARRAY_ELEMENT) ?
                     jsvIteratorGetValue(&it) :
-                    jsvNewFromInteger(jsvGetIntegerAndUnLock(jsvIteratorGetKey(&it)));
+                    jsvNewFromInteger(idxValue);
                 isDone = true;
               }
             } else if (!matched) // eg for .some
@@ -304,6 +321,7 @@ static JsVar *_jswrap_array_iterate_with_callback(
       jsvIteratorNext(&it);
     }
     jsvIteratorFree(&it);
+    jsvUnLock(args[1]);
   }
   /* boolean result depends on whether the loop terminated
      early for 'some' or completed for 'every' */
@@ -485,23 +503,25 @@ JsVar *jswrap_array_reduce(JsVar *parent, JsVar *funcVar, JsVar *initialValue) {
       jsExceptionHere(JSET_ERROR, "Array.%s without initial value required non-empty array", name);
     }
   }
+  JsVar *args[4];
+  args[2] = 0; // index - reused between calls if possible
+  args[3] = parent;
   while (jsvIteratorHasElement(&it)) {
     JsVar *index = jsvIteratorGetKey(&it);
     if (jsvIsInt(index)) {
       JsVarInt idxValue = jsvGetInteger(index);
 
-      JsVar *args[4];
       args[0] = previousValue;
       args[1] = jsvIteratorGetValue(&it);
-      args[2] = jsvNewFromInteger(idxValue); // child is a variable name, create a new variable for the index
-      args[3] = parent;
+      args[2] = _jswrap_array_iterate_index(args[2], idxValue);
       previousValue = jspeFunctionCall(funcVar, 0, 0, false, 4, args);
-      jsvUnLockMany(3,args);
+      jsvUnLockMany(2,args);
     }
     jsvUnLock(index);
     jsvIteratorNext(&it);
   }
   jsvIteratorFree(&it);
+  jsvUnLock(args[2]);
 
   return previousValue;
 }
@@ -721,10 +741,28 @@ Returns true if the provided object is an array
  */
 
 
-NO_INLINE static JsVarInt _jswrap_array_sort_compare(JsVar *a, JsVar *b, JsVar *compareFn) {
-  if (compareFn) {
+/* State for sorting an Array or ArrayBufferView with introsort. For Arrays
+ * and Objects we build a table of references to the element names up front
+ * with a JsvIterator, so we get random access without walking the linked
+ * list, and swap values between names. ArrayBuffers are indexed directly. */
+typedef struct {
+  JsVar *array;
+  JsVarRef *names; ///< element names, or 0 if array is an ArrayBuffer
+  JsVar *compareFn;
+} JswArraySort;
+
+NO_INLINE static JsVarInt _jswrap_array_sort_compare(JswArraySort *s, JsVar *a, JsVar *b) {
+  if (s->compareFn) {
     JsVar *args[2] = {a,b};
-    return jsvGetIntegerAndUnLock(jspeFunctionCall(compareFn, 0, 0, false, 2, args));
+    // compareFn may return fractional values, so don't round to an integer
+    JsVarFloat r = jsvGetFloatAndUnLock(jspeFunctionCall(s->compareFn, 0, 0, false, 2, args));
+    return (r>0) - (r<0);
+  } else if (!s->names) {
+    // ArrayBuffer elements sort numerically
+    JsVarFloat fa = jsvGetFloat(a), fb = jsvGetFloat(b);
+    if (isnan(fa)) return isnan(fb) ? 0 : 1;
+    if (isnan(fb)) return -1;
+    return (fa>fb) - (fa<fb);
   } else {
     JsVar *sa = jsvAsString(a);
     JsVar *sb = jsvAsString(b);
@@ -734,78 +772,312 @@ NO_INLINE static JsVarInt _jswrap_array_sort_compare(JsVar *a, JsVar *b, JsVar *
   }
 }
 
-NO_INLINE static void _jswrap_array_sort(JsvIterator *head, int n, JsVar *compareFn) {
-  if (n < 2) return; // sort done!
+static JsVar *_jswrap_array_sort_get(JswArraySort *s, int i) {
+  if (s->names) return jsvSkipNameAndUnLock(jsvLock(s->names[i]));
+  return jsvArrayBufferGet(s->array, (size_t)i);
+}
 
-  JsvIterator pivot;
-  jsvIteratorClone(&pivot, head);
-  bool pivotLowest = true; // is the pivot the lowest value in here?
-  JsVar *pivotValue = jsvIteratorGetValue(&pivot);
-  /* We're just going to use the first entry (head) as the pivot...
-   * We'll move along with our iterator 'it', and if it < pivot then we'll
-   * swap the values over (hence moving pivot forwards)  */
+static void _jswrap_array_sort_swap(JswArraySort *s, int i, int j) {
+  if (i==j) return;
+  JsVar *a = _jswrap_array_sort_get(s, i);
+  JsVar *b = _jswrap_array_sort_get(s, j);
+  if (s->names) {
+    jsvUnLock(jsvSetValueOfName(jsvLock(s->names[i]), b));
+    jsvUnLock(jsvSetValueOfName(jsvLock(s->names[j]), a));
+  } else {
+    jsvArrayBufferSet(s->array, (size_t)i, b);
+    jsvArrayBufferSet(s->array, (size_t)j, a);
+  }
+  jsvUnLock2(a, b);
+}
 
-  int nlo = 0, nhigh = 0;
-  JsvIterator it;
-  jsvIteratorClone(&it, head); //
-  jsvIteratorNext(&it);
-
-
-  /* Partition and count sizes. */
-  while (--n && !jspIsInterrupted()) {
-    JsVar *itValue = jsvIteratorGetValue(&it);
-    JsVarInt cmp = _jswrap_array_sort_compare(itValue, pivotValue, compareFn);
-    if (cmp<=0) {
-      if (cmp<0) pivotLowest = false;
-      nlo++;
-      /* 'it' <= 'pivot', so we need to move it behind.
-         In this diagram, P=pivot, L=it
-
-               l l l l l P h h h h h L
-                         |  \       /
-                          \  \_____/_
-                          _\______/  \
-                         / |         |
-                         | |         |
-               l l l l l L P h h h h h
-
-         It makes perfect sense now...
-       */
-      // first, get the old pivot value and overwrite it with the iterator value
-      jsvIteratorSetValue(&pivot, itValue); // no unlock needed
-      // now move pivot forwards, and set 'it' to the value the new pivot has
-      jsvIteratorNext(&pivot);
-      jsvUnLock(jsvIteratorSetValue(&it, jsvIteratorGetValue(&pivot)));
-      // finally set the pivot iterator to the pivot's value again
-      jsvIteratorSetValue(&pivot, pivotValue); // no unlock needed
+/// Compare element i with a value
+static JsVarInt _jswrap_array_sort_compareWith(JswArraySort *s, int i, JsVar *v) {
+  JsVar *a = _jswrap_array_sort_get(s, i);
+  JsVarInt r = _jswrap_array_sort_compare(s, a, v);
+  jsvUnLock(a);
+  return r;
+}
+
+/// Compare elements i and j
+static JsVarInt _jswrap_array_sort_compareIdx(JswArraySort *s, int i, int j) {
+  JsVar *b = _jswrap_array_sort_get(s, j);
+  JsVarInt r = _jswrap_array_sort_compareWith(s, i, b);
+  jsvUnLock(b);
+  return r;
+}
+
+static void _jswrap_array_sort_siftDown(JswArraySort *s, int lo, int root, int n) {
+  while (!jspIsInterrupted()) {
+    int child = root*2+1;
+    if (child >= n) return;
+    if (child+1 < n && _jswrap_array_sort_compareIdx(s, lo+child, lo+child+1)<0) child++;
+    if (_jswrap_array_sort_compareIdx(s, lo+root, lo+child)>=0) return;
+    _jswrap_array_sort_swap(s, lo+root, lo+child);
+    root = child;
+  }
+}
+
+static void _jswrap_array_sort_heapsort(JswArraySort *s, int lo, int n) {
+  int i;
+  for (i=n/2-1;i>=0;i--)
+    _jswrap_array_sort_siftDown(s, lo, i, n);
+  for (i=n-1;i>0 && !jspIsInterrupted();i--) {
+    _jswrap_array_sort_swap(s, lo, lo+i);
+    _jswrap_array_sort_siftDown(s, lo, 0, i);
+  }
+}
+
+static void _jswrap_array_sort_insertion(JswArraySort *s, int lo, int n) {
+  int i,j;
+  for (i=1;i<n && !jspIsInterrupted();i++) {
+    JsVar *v = _jswrap_array_sort_get(s, lo+i);
+    for (j=i;j>0 && _jswrap_array_sort_compareWith(s, lo+j-1, v)>0;j--)
+      _jswrap_array_sort_swap(s, lo+j-1, lo+j);
+    jsvUnLock(v);
+  }
+}
+
+/* Introsort: quicksort with a median-of-three pivot, insertion sort for
+ * small ranges and heapsort if we go too deep. The larger side of each
+ * partition goes on an explicit stack so we never recurse. */
+NO_INLINE static void _jswrap_array_sort(JswArraySort *s, int n) {
+  struct { int lo, n, depth; } stack[32];
+  int sp = 0;
+  int depth = 0;
+  while ((1<<depth) < n) depth++;
+  depth *= 2; // 2*log2(n) before we give up and use heapsort
+
+  int lo = 0;
+  while (!jspIsInterrupted()) {
+    if (n <= 16) {
+      _jswrap_array_sort_insertion(s, lo, n);
+      if (!sp) return;
+      sp--;
+      lo = stack[sp].lo;
+      n = stack[sp].n;
+      depth = stack[sp].depth;
+      continue;
+    }
+    if (depth-- <= 0) {
+      _jswrap_array_sort_heapsort(s, lo, n);
+      n = 0;
+      continue;
+    }
+    // median of three - then put it at the start as the pivot
+    int a = lo+1, b = lo+n/2, c = lo+n-1;
+    if (_jswrap_array_sort_compareIdx(s, b, a)<0) _jswrap_array_sort_swap(s, a, b);
+    if (_jswrap_array_sort_compareIdx(s, c, b)<0) {
+      _jswrap_array_sort_swap(s, b, c);
+      if (_jswrap_array_sort_compareIdx(s, b, a)<0) _jswrap_array_sort_swap(s, a, b);
+    }
+    _jswrap_array_sort_swap(s, lo, b);
+    JsVar *pivot = _jswrap_array_sort_get(s, lo);
+    /* Hoare partition - a and c are now sentinels, but we still check bounds
+     * in case compareFn isn't consistent */
+    int i = lo, j = lo+n;
+    while (!jspIsInterrupted()) {
+      do i++; while (i<lo+n-1 && _jswrap_array_sort_compareWith(s, i, pivot)<0);
+      do j--; while (j>lo && _jswrap_array_sort_compareWith(s, j, pivot)>0);
+      if (i >= j) break;
+      _jswrap_array_sort_swap(s, i, j);
+    }
+    jsvUnLock(pivot);
+    _jswrap_array_sort_swap(s, lo, j);
+    // stack the larger side, carry on with the smaller one
+    int nlo = j-lo, nhi = lo+n-j-1;
+    assert(sp < (int)(sizeof(stack)/sizeof(stack[0])));
+    if (nlo > nhi) {
+      stack[sp].lo = lo;
+      stack[sp].n = nlo;
+      lo = j+1;
+      n = nhi;
     } else {
-      nhigh++;
-      // Great, 'it' > 'pivot' so it's in the right place
+      stack[sp].lo = j+1;
+      stack[sp].n = nhi;
+      n = nlo;
     }
-    jsvUnLock(itValue);
-    jsvIteratorNext(&it);
+    stack[sp].depth = depth;
+    sp++;
   }
-  jsvIteratorFree(&it);
-  jsvUnLock(pivotValue);
+}
+
+#ifndef SAVE_ON_FLASH
+/* Native sort for typed arrays with no compare function. This works directly
+ * on the backing bytes rather than creating a JsVar for every element read,
+ * and uses an introsort so already-sorted data doesn't go quadratic. */
+typedef bool (*TypedSortLessFn)(const unsigned char *a, const unsigned char *b);
+
+#define TYPED_SORT_LESS(NAME, TYPE) \
+  static bool NAME(const unsigned char *a, const unsigned char *b) { \
+    TYPE va, vb; memcpy(&va, a, sizeof(TYPE)); memcpy(&vb, b, sizeof(TYPE)); \
+    return va < vb; \
+  }
+TYPED_SORT_LESS(_typedsort_less_u8, uint8_t)
+TYPED_SORT_LESS(_typedsort_less_i8, int8_t)
+TYPED_SORT_LESS(_typedsort_less_u16, uint16_t)
+TYPED_SORT_LESS(_typedsort_less_i16, int16_t)
+TYPED_SORT_LESS(_typedsort_less_u32, uint32_t)
+TYPED_SORT_LESS(_typedsort_less_i32, int32_t)
+
+static bool _typedsort_less_u24(const unsigned char *a, const unsigned char *b) {
+  uint32_t va = (uint32_t)(a[0] | (a[1]<<8) | (a[2]<<16));
+  uint32_t vb = (uint32_t)(b[0] | (b[1]<<8) | (b[2]<<16));
+  return va < vb;
+}
+// NaN sorts after everything else, as in the spec
+static bool _typedsort_less_f32(const unsigned char *a, const unsigned char *b) {
+  float va, vb; memcpy(&va, a, sizeof(float)); memcpy(&vb, b, sizeof(float));
+  return va < vb || (isnan(vb) && !isnan(va));
+}
+static bool _typedsort_less_f64(const unsigned char *a, const unsigned char *b) {
+  double va, vb; memcpy(&va, a, sizeof(double)); memcpy(&vb, b, sizeof(double));
+  return va < vb || (isnan(vb) && !isnan(va));
+}
 
-  if (jspIsInterrupted()) {
-    jsvIteratorFree(&pivot);
-    return;
+static void _typedsort_swap(unsigned char *a, unsigned char *b, int size) {
+  while (size--) {
+    unsigned char t = *a;
+    *(a++) = *b;
+    *(b++) = t;
   }
+}
+
+static void _typedsort_siftDown(unsigned char *d, int size, TypedSortLessFn less, int root, int n) {
+  while (true) {
+    int child = root*2+1;
+    if (child >= n) return;
+    if (child+1 < n && less(&d[child*size], &d[(child+1)*size])) child++;
+    if (!less(&d[root*size], &d[child*size])) return;
+    _typedsort_swap(&d[root*size], &d[child*size], size);
+    root = child;
+  }
+}
+
+static void _typedsort_heapsort(unsigned char *d, int size, TypedSortLessFn less, int n) {
+  int i;
+  for (i=n/2-1;i>=0;i--)
+    _typedsort_siftDown(d, size, less, i, n);
+  for (i=n-1;i>0;i--) {
+    _typedsort_swap(d, &d[i*size], size);
+    _typedsort_siftDown(d, size, less, 0, i);
+  }
+}
 
-  // now recurse. Do RHS first because we can
-  // free the pivot early if we do this
-  jsvIteratorNext(&pivot);
-  _jswrap_array_sort(&pivot, nhigh, compareFn);
-  jsvIteratorFree(&pivot);
-  // LHS
-  /* If the pivot is the lowest number in this chunk of numbers, then
-   * we know that anything to the left of it must be joint equal to it.
-   * In that casem there's no need to sort it. */
-  if (!pivotLowest)
-    _jswrap_array_sort(head, nlo, compareFn);
+static void _typedsort_insertion(unsigned char *d, int size, TypedSortLessFn less, int n) {
+  unsigned char v[8];
+  int i,j;
+  for (i=1;i<n;i++) {
+    if (!less(&d[i*size], &d[(i-1)*size])) continue;
+    memcpy(v, &d[i*size], (size_t)size);
+    j = i;
+    do {
+      memcpy(&d[j*size], &d[(j-1)*size], (size_t)size);
+      j--;
+    } while (j>0 && less(v, &d[(j-1)*size]));
+    memcpy(&d[j*size], v, (size_t)size);
+  }
 }
 
+/// Introsort: quicksort with median-of-three, heapsort if it goes too deep
+static void _typedsort(unsigned char *d, int size, TypedSortLessFn less, int n, int depth) {
+  while (n > 16) {
+    if (depth-- <= 0) {
+      _typedsort_heapsort(d, size, less, n);
+      return;
+    }
+    // median of three - put it at the start as the pivot
+    unsigned char *a = &d[size], *b = &d[(n/2)*size], *c = &d[(n-1)*size];
+    if (less(b, a)) _typedsort_swap(a, b, size);
+    if (less(c, b)) {
+      _typedsort_swap(b, c, size);
+      if (less(b, a)) _typedsort_swap(a, b, size);
+    }
+    _typedsort_swap(d, b, size);
+    // Hoare partition - a and c are now sentinels
+    int i = 0, j = n;
+    while (true) {
+      do i++; while (less(&d[i*size], d));
+      do j--; while (less(d, &d[j*size]));
+      if (i >= j) break;
+      _typedsort_swap(&d[i*size], &d[j*size], size);
+    }
+    _typedsort_swap(d, &d[j*size], size);
+    // recurse on the smaller side, loop on the larger to bound the stack
+    if (j < n-j-1) {
+      _typedsort(d, size, less, j, depth);
+      d += (j+1)*size;
+      n -= j+1;
+    } else {
+      _typedsort(&d[(j+1)*size], size, less, n-j-1, depth);
+      n = j;
+    }
+  }
+  _typedsort_insertion(d, size, less, n);
+}
+
+/// Sort a typed array in place numerically. Returns false if it couldn't be done natively
+static bool _jswrap_array_sort_typed(JsVar *array) {
+  JsVarDataArrayBufferViewType type = array->varData.arraybuffer.type;
+  TypedSortLessFn less = 0;
+  // clamping only matters when writing, so Uint8ClampedArray sorts like Uint8Array
+  switch ((JsVarDataArrayBufferViewType)(type & ~ARRAYBUFFERVIEW_CLAMPED)) {
+    case ARRAYBUFFERVIEW_ARRAYBUFFER:
+    case ARRAYBUFFERVIEW_UINT8: less = _typedsort_less_u8; break;
+    case ARRAYBUFFERVIEW_INT8: less = _typedsort_less_i8; break;
+    case ARRAYBUFFERVIEW_UINT16: less = _typedsort_less_u16; break;
+    case ARRAYBUFFERVIEW_INT16: less = _typedsort_less_i16; break;
+    case ARRAYBUFFERVIEW_UINT24: less = _typedsort_less_u24; break;
+    case ARRAYBUFFERVIEW_UINT32: less = _typedsort_less_u32; break;
+    case ARRAYBUFFERVIEW_INT32: less = _typedsort_less_i32; break;
+    case ARRAYBUFFERVIEW_FLOAT32: less = _typedsort_less_f32; break;
+    case ARRAYBUFFERVIEW_FLOAT64: less = _typedsort_less_f64; break;
+    default: return false; // big endian, etc
+  }
+  int size = (int)JSV_ARRAYBUFFER_GET_SIZE(type);
+  int n = (int)jsvGetLength(array);
+  if (n < 2) return true;
+  // depth limit of 2*log2(n) before we switch to heapsort
+  int depth = 0;
+  while ((1<<depth) < n) depth++;
+  depth *= 2;
+
+  JsVar *backing = jsvGetArrayBufferBackingString(array);
+  if (!backing) return false;
+  if (jsvIsFlashString(backing)) { // can't write to flash directly
+    jsvUnLock(backing);
+    return false;
+  }
+  size_t len;
+  unsigned char *d = (unsigned char*)jsvGetDataPointer(array, &len);
+  if (d) {
+    _typedsort(d, size, less, n, depth);
+  } else {
+    /* Not flat, so copy the data out into a flat string, sort it there,
+     * and copy it back */
+    size_t byteLength = (size_t)(n*size);
+    size_t byteOffset = array->varData.arraybuffer.byteOffset;
+    JsVar *tmp = jsvNewFlatStringOfLength((unsigned int)byteLength);
+    if (!tmp) {
+      jsvUnLock(backing);
+      return false;
+    }
+    d = (unsigned char*)jsvGetFlatStringPointer(tmp);
+    jsvGetStringChars(backing, byteOffset, (char*)d, byteLength);
+    _typedsort(d, size, less, n, depth);
+    JsvStringIterator it;
+    jsvStringIteratorNew(&it, backing, byteOffset);
+    size_t i;
+    for (i=0;i<byteLength;i++)
+      jsvStringIteratorSetCharAndNext(&it, (char)d[i]);
+    jsvStringIteratorFree(&it);
+    jsvUnLock(tmp);
+  }
+  jsvUnLock(backing);
+  return true;
+}
+#endif
+
 /*JSON{
   "type" : "method",
   "class" : "Array",
@@ -817,39 +1089,75 @@ NO_INLINE static void _jswrap_array_sort(JsvIterator *head, int n, JsVar *compar
   ],
   "return" : ["JsVar","This array object"]
 }
-Do an in-place quicksort of the array
+Do an in-place sort of the array. This is an introsort, so it won't go
+quadratic on sorted or reversed input.
  */
 JsVar *jswrap_array_sort (JsVar *array, JsVar *compareFn) {
   if (!jsvIsUndefined(compareFn) && !jsvIsFunction(compareFn)) {
     jsExceptionHere(JSET_ERROR, "Expecting compare function, got %t", compareFn);
     return 0;
   }
-  JsvIterator it;
-
-  /* Arrays can be sparse and the iterators don't handle this
-    (we're not going to mess with indices) so we have to count
-     up the number of elements manually.
-
-     FIXME: sort is broken for sparse arrays anyway (it basically
-     ignores all the 'undefined' entries). I wonder whether just
-     compacting the array down to start from 0 before we start would
-     fix this?
-   */
-  int n=0;
+  if (jsvIsArrayBuffer(array) && jsvIsArrayBufferReadOnly(array))
+    return jsvLockAgain(array); // can't write to it, so nothing to do
+#ifndef SAVE_ON_FLASH
+  /* Typed arrays with no compare function sort numerically, and we
+   * can do that directly on the data */
+  if (jsvIsArrayBuffer(array) && jsvIsUndefined(compareFn) && _jswrap_array_sort_typed(array))
+    return jsvLockAgain(array);
+#endif
+
+  JswArraySort s;
+  s.array = array;
+  s.names = 0;
+  s.compareFn = jsvIsUndefined(compareFn) ? 0 : compareFn;
+  int n = 0;
+  JsVar *namesVar = 0;
   if (jsvIsArray(array) || jsvIsObject(array)) {
-    jsvIteratorNew(&it, array, JSIF_EVERY_ARRAY_ELEMENT);
+    /* FIXME: Arrays can be sparse - we just sort the elements that exist
+     * and leave them at the indices they were at, rather than moving
+     * everything down and putting the 'undefined' entries at the end. */
+    JsvIterator it;
+    jsvIteratorNew(&it, array, JSIF_DEFINED_ARRAY_ElEMENTS);
     while (jsvIteratorHasElement(&it)) {
       n++;
       jsvIteratorNext(&it);
     }
     jsvIteratorFree(&it);
-  } else {
+    if (n < 2) return jsvLockAgain(array);
+    size_t namesSize = (size_t)n*sizeof(JsVarRef);
+    namesVar = jsvNewFlatStringOfLength((unsigned int)namesSize);
+    if (namesVar) {
+      s.names = (JsVarRef*)jsvGetFlatStringPointer(namesVar);
+    } else if (namesSize < jsuGetFreeStack()/4) {
+      // no contiguous space in variable storage, but it'll fit on the stack
+      s.names = (JsVarRef*)alloca(namesSize);
+    } else {
+      jsExceptionHere(JSET_ERROR, "Not enough memory to sort %d elements", n);
+      return 0;
+    }
+    int i = 0;
+    jsvIteratorNew(&it, array, JSIF_DEFINED_ARRAY_ElEMENTS);
+    while (jsvIteratorHasElement(&it) && i<n) {
+      JsVar *name = jsvIteratorGetKey(&it);
+      s.names[i++] = jsvGetRef(jsvRef(name));
+      jsvUnLock(name);
+      jsvIteratorNext(&it);
+    }
+    jsvIteratorFree(&it);
+    n = i;
+  } else if (jsvIsArrayBuffer(array)) {
     n = (int)jsvGetLength(array);
   }
 
-  jsvIteratorNew(&it, array, JSIF_EVERY_ARRAY_ELEMENT);
-  _jswrap_array_sort(&it, n, compareFn);
-  jsvIteratorFree(&it);
+  _jswrap_array_sort(&s, n);
+
+  if (s.names) {
+    // we referenced the names so they couldn't be freed if compareFn removed them
+    int i;
+    for (i=0;i<n;i++)
+      jsvUnRefRef(s.names[i]);
+    jsvUnLock(namesVar);
+  }
   return jsvLockAgain(array);
 }
 
@@ -48,6 +48,12 @@ This is the built-in JavaScript class that is the prototype for:
 
 If you want to access arrays of differing types of data
 you may also find `DataView` useful.
+
+Typed arrays can also be created from a String. Strings that point straight
+at memory (eg. from `E.memoryArea` or `require("Storage").read`) are referenced
+rather than copied so no RAM is used, but as the data may well be in flash the
+resulting array is read-only - writes to it are ignored. Any other String is
+copied, so modifying the array won't change the original String.
 */
 
 /*JSON{
@@ -252,6 +258,8 @@ The length, in bytes, of the `ArrayBuffer`
   "return_object" : "ArrayBufferView"
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
+
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
  */
 /*JSON{
   "type" : "constructor",
@@ -268,6 +276,8 @@ Create a typed array based on the given input. Either an existing Array Buffer,
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
 
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
+
 Clamped arrays clamp their values to the allowed range, rather than 'wrapping'. e.g. after `a[0]=12345;`, `a[0]==255`.
  */
 /*JSON{
@@ -284,6 +294,8 @@ Clamped arrays clamp their values to the allowed range, rather than 'wrapping'.
   "return_object" : "ArrayBufferView"
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
+
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
  */
 /*JSON{
   "type" : "constructor",
@@ -299,6 +311,8 @@ Create a typed array based on the given input. Either an existing Array Buffer,
   "return_object" : "ArrayBufferView"
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
+
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
  */
 /*JSON{
   "type" : "constructor",
@@ -314,6 +328,8 @@ Create a typed array based on the given input. Either an existing Array Buffer,
   "return_object" : "ArrayBufferView"
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
+
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
  */
 /*JSON{
   "type" : "constructor",
@@ -329,6 +345,8 @@ Create a typed array based on the given input. Either an existing Array Buffer,
   "return_object" : "ArrayBufferView"
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
+
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
  */
 /*JSON{
   "type" : "constructor",
@@ -345,6 +363,8 @@ Create a typed array based on the given input. Either an existing Array Buffer,
   "return_object" : "ArrayBufferView"
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
+
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
  */
 /*JSON{
   "type" : "constructor",
@@ -360,6 +380,8 @@ Create a typed array based on the given input. Either an existing Array Buffer,
   "return_object" : "ArrayBufferView"
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
+
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
  */
 /*JSON{
   "type" : "constructor",
@@ -375,6 +397,8 @@ Create a typed array based on the given input. Either an existing Array Buffer,
   "return_object" : "ArrayBufferView"
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
+
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
  */
 /*JSON{
   "type" : "constructor",
@@ -390,6 +414,8 @@ Create a typed array based on the given input. Either an existing Array Buffer,
   "return_object" : "ArrayBufferView"
 }
 Create a typed array based on the given input. Either an existing Array Buffer, an Integer as a Length, or a simple array. If an `ArrayBufferView` (eg. `Uint8Array` rather than `ArrayBuffer`) is given, it will be completely copied rather than referenced.
+
+A String may also be given - see [ArrayBufferView](/Reference#ArrayBufferView).
  */
 
 JsVar *jswrap_typedarray_constructor(JsVarDataArrayBufferViewType type, JsVar *arr, JsVarInt byteOffset, JsVarInt length) {
@@ -398,6 +424,22 @@ JsVar *jswrap_typedarray_constructor(JsVarDataArrayBufferViewType type, JsVar *a
   bool copyData = false;
   if (jsvIsArrayBuffer(arr) && arr->varData.arraybuffer.type==ARRAYBUFFERVIEW_ARRAYBUFFER) {
     arrayBuffer = jsvLockAgain(arr);
+  } else if (jsvIsNativeString(arr) || jsvIsFlashString(arr)) {
+    /* Reference the String's data directly (eg. from Storage.read) so we
+     * don't copy anything into RAM. It may well be in flash, so make it
+     * read-only */
+    arrayBuffer = jsvNewArrayBufferFromString(arr, 0);
+    if (arrayBuffer) arrayBuffer->flags |= JSV_ARRAYBUFFER_READONLY;
+  } else if (jsvIsString(arr)) {
+    // Strings are immutable, so we must copy them
+    size_t len = jsvGetStringLength(arr);
+    JsVar *str = jsvNewFlatStringOfLength((unsigned int)len);
+    if (str)
+      jsvGetStringChars(arr, 0, jsvGetFlatStringPointer(str), len);
+    else
+      str = jsvNewFromStringVar(arr, 0, JSVAPPENDSTRINGVAR_MAXLENGTH);
+    arrayBuffer = jsvNewArrayBufferFromString(str, 0);
+    jsvUnLock(str);
   } else if (jsvIsNumeric(arr)) {
     length = jsvGetInteger(arr);
     byteOffset = 0;
@@ -514,6 +556,58 @@ void jswrap_arraybufferview_set(JsVar *parent, JsVar *arr, int offset) {
 }
 
 
+/*JSON{
+  "type" : "method",
+  "class" : "ArrayBufferView",
+  "name" : "subarray",
+  "ifndef" : "SAVE_ON_FLASH",
+  "generate" : "jswrap_arraybufferview_subarray",
+  "params" : [
+    ["begin","int","Element to begin at, inclusive. If negative, this is from the end of the array. The entire array will be included if this isn't specified"],
+    ["end","JsVar","Element to end at, exclusive. If negative, it is relative to the end of the array. If not specified the whole array is included"]
+  ],
+  "return" : ["JsVar","An `ArrayBufferView` of the same type as this one, referencing the same data"],
+  "return_object" : "ArrayBufferView"
+}
+Returns a smaller part of this array, without copying any data. The new
+array references the same `ArrayBuffer`, so changing elements in one
+changes them in the other:
+
+```
+var a = new Uint8Array([1,2,3,4,5]);
+var b = a.subarray(1,3); // Uint8Array [2,3]
+b[0] = 42; // a = [1,42,3,4,5]
+```
+ */
+JsVar *jswrap_arraybufferview_subarray(JsVar *parent, JsVarInt begin, JsVar *endVar) {
+  if (!jsvIsArrayBuffer(parent)) return 0;
+  JsVarDataArrayBufferViewType type = parent->varData.arraybuffer.type;
+  JsVar *arrayBuffer;
+  if (type == ARRAYBUFFERVIEW_ARRAYBUFFER) {
+    // a plain ArrayBuffer - view it as bytes
+    type = ARRAYBUFFERVIEW_UINT8;
+    arrayBuffer = jsvLockAgain(parent);
+  } else
+    arrayBuffer = jsvLock(jsvGetFirstChild(parent));
+  JsVarInt length = parent->varData.arraybuffer.length;
+  JsVarInt end = jsvIsUndefined(endVar) ? length : jsvGetInteger(endVar);
+  if (begin<0) begin += length;
+  if (end<0) end += length;
+  if (begin<0) begin = 0;
+  if (end>length) end = length;
+  if (end<begin) end = begin;
+
+  JsVar *view = jsvNewWithFlags(JSV_ARRAYBUFFER);
+  if (view) {
+    view->varData.arraybuffer.type = type;
+    view->varData.arraybuffer.byteOffset = (unsigned short)(parent->varData.arraybuffer.byteOffset + begin*(JsVarInt)JSV_ARRAYBUFFER_GET_SIZE(type));
+    view->varData.arraybuffer.length = (unsigned short)(end-begin);
+    jsvSetFirstChild(view, jsvGetRef(jsvRef(arrayBuffer)));
+  }
+  jsvUnLock(arrayBuffer);
+  return view;
+}
+
 // 'special' ArrayBufferView.map as it needs to return an ArrayBuffer
 /*JSON{
   "type" : "method",
@@ -639,6 +733,9 @@ Join all elements of this array together into one string, using 'separator' betw
   "return_object" : "ArrayBufferView"
 }
 Do an in-place quicksort of the array
+
+If no compare function is given, elements are sorted numerically directly on
+the underlying data (NaN sorts last).
  */
 /*JSON{
   "type" : "method",
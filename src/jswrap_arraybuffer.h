@@ -16,4 +16,5 @@
 JsVar *jswrap_arraybuffer_constructor(JsVarInt byteLength);
 JsVar *jswrap_typedarray_constructor(JsVarDataArrayBufferViewType type, JsVar *arr, JsVarInt byteOffset, JsVarInt length);
 void jswrap_arraybufferview_set(JsVar *parent, JsVar *arr, int offset);
+JsVar *jswrap_arraybufferview_subarray(JsVar *parent, JsVarInt begin, JsVar *endVar);
 JsVar *jswrap_arraybufferview_map(JsVar *parent, JsVar *funcVar, JsVar *thisVar);
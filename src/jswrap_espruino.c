@@ -231,6 +231,110 @@ JsVarFloat jswrap_espruino_clip(JsVarFloat x, JsVarFloat min, JsVarFloat max) {
 }
 
 
+#ifndef SAVE_ON_FLASH
+/* Fast paths for the DSP functions below. If arr is a Uint8Array (or plain
+ * ArrayBuffer), Int16Array or Float32Array whose data is contiguous and
+ * suitably aligned, return a pointer to the data and set the element type
+ * and count. Otherwise return 0, and the generic iterator code is used. */
+static void *_jswrap_espruino_getDSPData(JsVar *arr, JsVarDataArrayBufferViewType *type, size_t *count) {
+  if (!jsvIsArrayBuffer(arr)) return 0;
+  JsVarDataArrayBufferViewType t = arr->varData.arraybuffer.type;
+  if (t==ARRAYBUFFERVIEW_ARRAYBUFFER) t = ARRAYBUFFERVIEW_UINT8;
+  if (t!=ARRAYBUFFERVIEW_UINT8 && t!=ARRAYBUFFERVIEW_INT16 && t!=ARRAYBUFFERVIEW_FLOAT32)
+    return 0;
+  size_t len;
+  char *ptr = jsvGetDataPointer(arr, &len);
+  // some platforms can't do unaligned 16/32 bit (or float) accesses
+  if (!ptr || ((size_t)ptr & (JSV_ARRAYBUFFER_GET_SIZE(t)-1))) return 0;
+  *type = t;
+  *count = arr->varData.arraybuffer.length;
+  return ptr;
+}
+
+/* Integer data is summed into a 32 bit integer. That's exact because typed
+ * arrays have at most JSV_ARRAYBUFFER_MAX_LENGTH (65535) elements, so the sum
+ * can't overflow. Floats use 4 accumulators so that the additions can be done
+ * in parallel. */
+static JsVarFloat _jswrap_espruino_sumDSP(void *data, JsVarDataArrayBufferViewType type, size_t n) {
+  size_t i;
+  if (type==ARRAYBUFFERVIEW_UINT8) {
+    const uint8_t *d = (const uint8_t*)data;
+    uint32_t s = 0; // can't overflow - 65535*255 max
+    for (i=0;i<n;i++) s += d[i];
+    return (JsVarFloat)s;
+  } else if (type==ARRAYBUFFERVIEW_INT16) {
+    const int16_t *d = (const int16_t*)data;
+    int32_t s = 0; // can't overflow - 65535*32768 max
+    for (i=0;i<n;i++) s += d[i];
+    return (JsVarFloat)s;
+  } else {
+    const float *d = (const float*)data;
+    JsVarFloat s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (i=0;i+4<=n;i+=4) {
+      s0 += d[i]; s1 += d[i+1]; s2 += d[i+2]; s3 += d[i+3];
+    }
+    for (;i<n;i++) s0 += d[i];
+    return (s0+s1)+(s2+s3);
+  }
+}
+
+static JsVarFloat _jswrap_espruino_varianceDSP(void *data, JsVarDataArrayBufferViewType type, size_t n, JsVarFloat mean) {
+  size_t i;
+  JsVarFloat v0 = 0, v1 = 0;
+  if (type==ARRAYBUFFERVIEW_UINT8) {
+    const uint8_t *d = (const uint8_t*)data;
+    for (i=0;i<n;i++) {
+      JsVarFloat x = d[i] - mean;
+      v0 += x*x;
+    }
+  } else if (type==ARRAYBUFFERVIEW_INT16) {
+    const int16_t *d = (const int16_t*)data;
+    for (i=0;i<n;i++) {
+      JsVarFloat x = d[i] - mean;
+      v0 += x*x;
+    }
+  } else {
+    const float *d = (const float*)data;
+    for (i=0;i+2<=n;i+=2) {
+      JsVarFloat x0 = d[i] - mean, x1 = d[i+1] - mean;
+      v0 += x0*x0;
+      v1 += x1*x1;
+    }
+    for (;i<n;i++) {
+      JsVarFloat x = d[i] - mean;
+      v0 += x*x;
+    }
+  }
+  return v0+v1;
+}
+
+/* Dot product of n elements of a and b (which must be the same type). Int16
+ * is done in fixed point with a 64 bit accumulator, so is exact. */
+static JsVarFloat _jswrap_espruino_dotDSP(void *a, void *b, JsVarDataArrayBufferViewType type, size_t n) {
+  size_t i;
+  if (type==ARRAYBUFFERVIEW_UINT8) {
+    const uint8_t *da = (const uint8_t*)a, *db = (const uint8_t*)b;
+    uint32_t s = 0; // can't overflow - 65535*255*255 max
+    for (i=0;i<n;i++) s += (uint32_t)da[i]*db[i];
+    return (JsVarFloat)s;
+  } else if (type==ARRAYBUFFERVIEW_INT16) {
+    const int16_t *da = (const int16_t*)a, *db = (const int16_t*)b;
+    int64_t s = 0;
+    for (i=0;i<n;i++) s += (int32_t)da[i]*db[i];
+    return (JsVarFloat)s;
+  } else {
+    const float *da = (const float*)a, *db = (const float*)b;
+    JsVarFloat s0 = 0, s1 = 0;
+    for (i=0;i+2<=n;i+=2) {
+      s0 += (JsVarFloat)da[i]*db[i];
+      s1 += (JsVarFloat)da[i+1]*db[i+1];
+    }
+    for (;i<n;i++) s0 += (JsVarFloat)da[i]*db[i];
+    return s0+s1;
+  }
+}
+#endif
+
 /*JSON{
   "type" : "staticmethod",
   "ifndef" : "SAVE_ON_FLASH",
@@ -249,6 +353,12 @@ JsVarFloat jswrap_espruino_sum(JsVar *arr) {
     jsExceptionHere(JSET_ERROR, "Expecting first argument to be an array, not %t", arr);
     return NAN;
   }
+#ifndef SAVE_ON_FLASH
+  JsVarDataArrayBufferViewType type;
+  size_t n;
+  void *data = _jswrap_espruino_getDSPData(arr, &type, &n);
+  if (data) return _jswrap_espruino_sumDSP(data, type, n);
+#endif
   JsVarFloat sum = 0;
 
   JsvIterator itsrc;
@@ -280,6 +390,12 @@ JsVarFloat jswrap_espruino_variance(JsVar *arr, JsVarFloat mean) {
     jsExceptionHere(JSET_ERROR, "Expecting first argument to be iterable, not %t", arr);
     return NAN;
   }
+#ifndef SAVE_ON_FLASH
+  JsVarDataArrayBufferViewType type;
+  size_t n;
+  void *data = _jswrap_espruino_getDSPData(arr, &type, &n);
+  if (data) return _jswrap_espruino_varianceDSP(data, type, n, mean);
+#endif
   JsVarFloat variance = 0;
 
   JsvIterator itsrc;
@@ -315,6 +431,28 @@ JsVarFloat jswrap_espruino_convolve(JsVar *arr1, JsVar *arr2, int offset) {
     jsExceptionHere(JSET_ERROR, "Expecting first 2 arguments to be iterable, not %t and %t", arr1, arr2);
     return NAN;
   }
+#ifndef SAVE_ON_FLASH
+  JsVarDataArrayBufferViewType type1, type2;
+  size_t n1, n2;
+  void *data1 = _jswrap_espruino_getDSPData(arr1, &type1, &n1);
+  void *data2 = data1 ? _jswrap_espruino_getDSPData(arr2, &type2, &n2) : 0;
+  if (data2 && type1==type2 && n2) {
+    /* Go through arr1, using arr2 from offset up to its end and then
+     * wrapping around - so each chunk is a simple dot product */
+    int o = offset % (int)n2;
+    if (o<0) o += (int)n2;
+    size_t pos = 0, elSize = JSV_ARRAYBUFFER_GET_SIZE(type1);
+    JsVarFloat conv = 0;
+    while (pos<n1) {
+      size_t chunk = n2-(size_t)o;
+      if (chunk > n1-pos) chunk = n1-pos;
+      conv += _jswrap_espruino_dotDSP((char*)data1 + pos*elSize, (char*)data2 + (size_t)o*elSize, type1, chunk);
+      pos += chunk;
+      o = 0;
+    }
+    return conv;
+  }
+#endif
   JsVarFloat conv = 0;
 
   JsvIterator it1;
@@ -351,6 +489,89 @@ JsVarFloat jswrap_espruino_convolve(JsVar *arr1, JsVar *arr2, int offset) {
 #define FFTDATATYPE float
 #endif
 
+#if !defined(SAVE_ON_FLASH) && !defined(SAVE_ON_FLASH_MATH)
+/* In-place forward FFT of n/2 complex points stored interleaved (re,im,re,im)
+ * in d, where n is a power of 2 */
+static void _jswrap_espruino_FFT_interleaved(float *d, size_t n) {
+  size_t m = n>>1; // complex points
+  size_t i,j,k;
+  // bit reversal
+  j = 0;
+  for (i=0;i<m-1;i++) {
+    if (i < j) {
+      float t;
+      t = d[i*2]; d[i*2] = d[j*2]; d[j*2] = t;
+      t = d[i*2+1]; d[i*2+1] = d[j*2+1]; d[j*2+1] = t;
+    }
+    k = m>>1;
+    while (k <= j) {
+      j -= k;
+      k >>= 1;
+    }
+    j += k;
+  }
+  // butterflies
+  size_t l1, l2;
+  for (l1=1;l1<m;l1=l2) {
+    l2 = l1<<1;
+    JsVarFloat theta = -PI / (JsVarFloat)l1;
+    float wr = (float)jswrap_math_sin(theta + (PI/2)), wi = (float)jswrap_math_sin(theta);
+    float ur = 1, ui = 0;
+    for (j=0;j<l1;j++) {
+      for (i=j;i<m;i+=l2) {
+        size_t a = i*2, b = (i+l1)*2;
+        float tr = ur*d[b] - ui*d[b+1];
+        float ti = ur*d[b+1] + ui*d[b];
+        d[b] = d[a] - tr;
+        d[b+1] = d[a+1] - ti;
+        d[a] += tr;
+        d[a+1] += ti;
+      }
+      float t = ur*wr - ui*wi;
+      ui = ur*wi + ui*wr;
+      ur = t;
+    }
+  }
+}
+
+/* Forward FFT of n real values (n a power of 2, at least 4) in place, writing
+ * back the modulus of the result scaled by 1/n - the same output
+ * E.FFT gives with no imaginary array, but without needing any extra
+ * memory. The data is treated as n/2 complex points, transformed, and then
+ * split into the spectrum of the real input. */
+static void _jswrap_espruino_FFT_real(float *d, size_t n) {
+  size_t h = n>>1, k;
+  _jswrap_espruino_FFT_interleaved(d, n);
+  // X[0] and X[n/2] are both real, and come from Z[0]
+  float x0 = d[0] + d[1];
+  float xh = d[0] - d[1];
+  // Now pair up Z[k] and Z[h-k] to get X[k] and X[h-k]
+  for (k=1;k<=h/2;k++) {
+    size_t a = k*2, b = (h-k)*2;
+    float zr = d[a], zi = d[a+1], cr = d[b], ci = -d[b+1]; // Z[k] and conj(Z[h-k])
+    float er = (zr + cr)*0.5f, ei = (zi + ci)*0.5f; // even
+    float or_ = (zi - ci)*0.5f, oi = -(zr - cr)*0.5f; // odd = -i*(Z[k]-conj(Z[h-k]))/2
+    JsVarFloat theta = -2*PI*(JsVarFloat)k / (JsVarFloat)n;
+    float wr = (float)jswrap_math_sin(theta + (PI/2)), wi = (float)jswrap_math_sin(theta);
+    float tr = wr*or_ - wi*oi, ti = wr*oi + wi*or_;
+    // X[k] = E + W*O, and X[h-k] = conj(E - W*O)
+    d[a] = er + tr;
+    d[a+1] = ei + ti;
+    d[b] = er - tr;
+    d[b+1] = -(ei - ti);
+  }
+  // Replace each complex value with its scaled modulus, packed at the start
+  float scale = 1.0f / (float)n;
+  d[0] = x0<0 ? -x0*scale : x0*scale;
+  for (k=1;k<h;k++)
+    d[k] = (float)jswrap_math_sqrt(d[k*2]*d[k*2] + d[k*2+1]*d[k*2+1]) * scale;
+  d[h] = xh<0 ? -xh*scale : xh*scale;
+  // the spectrum of real data is symmetric
+  for (k=1;k<h;k++)
+    d[n-k] = d[k];
+}
+#endif
+
 // http://paulbourke.net/miscellaneous/dft/
 /*
    This computes an in-place complex-to-complex FFT
@@ -444,9 +665,9 @@ Performs a Fast Fourier Transform (FFT) in 32 bit floats on the supplied data an
 original arrays. Note that if only one array is supplied, the data written back is the modulus of the complex
 result `sqrt(r*r+i*i)`.
 
-In order to perform the FFT, there has to be enough room on the stack to allocate two arrays of 32 bit
-floating point numbers - this will limit the maximum size of FFT possible to around 1024 items on
-most platforms.
+In order to perform the FFT, two arrays of 32 bit floating point numbers are allocated - on the stack
+if there's room, or in variable storage if not. However if `arrReal` is a `Float32Array` whose length is a
+power of 2 and `arrImage` is undefined, a forward FFT is done in-place without any extra memory.
 
 **Note:** on the Original Espruino board, FFTs are performed in 64bit arithmetic as there isn't
 space to include the 32 bit maths routines (2x more RAM is required).
@@ -498,12 +719,36 @@ void jswrap_espruino_FFT(JsVar *arrReal, JsVar *arrImag, bool inverse) {
     order++;
   }
 
-  if (jsuGetFreeStack() < 256+sizeof(FFTDATATYPE)*pow2*2) {
-    jsExceptionHere(JSET_ERROR, "Insufficient stack for computing FFT");
-    return;
+#if !defined(SAVE_ON_FLASH) && !defined(SAVE_ON_FLASH_MATH)
+  /* A forward FFT of a Float32Array that's a power of 2 in length with
+   * no imaginary part can be done in place, with no extra memory */
+  if (!inverse && jsvIsUndefined(arrImag) && l==pow2 && l>=4 &&
+      !(jsvIsArrayBuffer(arrReal) && jsvIsArrayBufferReadOnly(arrReal))) {
+    JsVarDataArrayBufferViewType type;
+    size_t n;
+    float *data = (float*)_jswrap_espruino_getDSPData(arrReal, &type, &n);
+    if (data && type==ARRAYBUFFERVIEW_FLOAT32) {
+      _jswrap_espruino_FFT_real(data, n);
+      return;
+    }
   }
+#endif
 
-  FFTDATATYPE *vReal = (FFTDATATYPE*)alloca(sizeof(FFTDATATYPE)*pow2*2);
+  /* Use the stack for working space if we can, or a flat string if
+   * there isn't enough stack */
+  size_t workSize = sizeof(FFTDATATYPE)*pow2*2;
+  JsVar *workVar = 0;
+  FFTDATATYPE *vReal;
+  if (jsuGetFreeStack() >= 256+workSize) {
+    vReal = (FFTDATATYPE*)alloca(workSize);
+  } else {
+    workVar = jsvNewFlatStringOfLength((unsigned int)workSize);
+    if (!workVar) {
+      jsExceptionHere(JSET_ERROR, "Not enough memory for computing FFT");
+      return;
+    }
+    vReal = (FFTDATATYPE*)jsvGetFlatStringPointer(workVar);
+  }
   FFTDATATYPE *vImag = &vReal[pow2];
 
   // load data
@@ -519,6 +764,7 @@ void jswrap_espruino_FFT(JsVar *arrReal, JsVar *arrImag, bool inverse) {
   _jswrap_espruino_FFT_setData(arrReal, vReal, hasImagResult?0:vImag, pow2);
   if (hasImagResult)
     _jswrap_espruino_FFT_setData(arrImag, vImag, 0, pow2);
+  jsvUnLock(workVar);
 }
 
 /*JSON{
@@ -1509,6 +1755,160 @@ void jswrap_espruino_mapInPlace(JsVar *from, JsVar *to, JsVar *map, JsVarInt bit
   jsvArrayBufferIteratorFree(&itTo);
 }
 
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "class" : "E",
+  "name" : "vecOp",
+  "generate" : "jswrap_espruino_vecOp",
+  "params" : [
+    ["dst","JsVar","An ArrayBuffer to write the results to (this can be the same as `a`)"],
+    ["a","JsVar","An ArrayBuffer to read the first operand from"],
+    ["b","JsVar","An ArrayBuffer to read the second operand from, or a number to use for every element"],
+    ["op","JsVar","The operation: `\"add\"`, `\"sub\"`, `\"mul\"`, `\"min\"`, `\"max\"`, `\"abs\"` or `\"clip\"`"]
+  ]
+}
+Perform an element-wise operation on typed arrays, writing the results
+into `dst`. This is done natively, without calling JavaScript or allocating
+variables for each element:
+
+* `add` : `dst[i] = a[i] + b[i]`
+* `sub` : `dst[i] = a[i] - b[i]`
+* `mul` : `dst[i] = a[i] * b[i]`
+* `min` : `dst[i] = Math.min(a[i], b[i])`
+* `max` : `dst[i] = Math.max(a[i], b[i])`
+* `abs` : `dst[i] = Math.abs(a[i])` (`b` is ignored)
+* `clip` : `dst[i] = E.clip(a[i], b[0], b[1])` - `b` is an array of `[min,max]`
+
+Except for `clip`, `b` can be a number instead of an array, in which case it's
+used for every element. Only as many elements as are in the shortest array are processed.
+
+Unlike normal writes to typed arrays, results that are out of range for an
+integer `dst` array are saturated to the nearest value that fits, rather than
+wrapping around. For instance:
+
+```
+var a = new Int16Array([1000,-2000,30000]);
+E.vecOp(a, a, 2, "mul"); // a = [2000,-4000,32767]
+var b = new Int16Array([1,2,3]);
+E.vecOp(a, a, b, "add"); // a = [2001,-3998,32767]
+E.vecOp(a, a, [-3000,3000], "clip"); // a = [2001,-3000,3000]
+```
+ */
+typedef enum {
+  VECOP_ADD, VECOP_SUB, VECOP_MUL, VECOP_MIN, VECOP_MAX, VECOP_ABS, VECOP_CLIP
+} JswVecOp;
+
+void jswrap_espruino_vecOp(JsVar *dst, JsVar *a, JsVar *b, JsVar *op) {
+  if (!jsvIsArrayBuffer(dst) || !jsvIsArrayBuffer(a)) {
+    jsExceptionHere(JSET_ERROR, "First 2 arguments should be array buffers");
+    return;
+  }
+  JswVecOp o;
+  if (jsvIsStringEqual(op,"add")) o = VECOP_ADD;
+  else if (jsvIsStringEqual(op,"sub")) o = VECOP_SUB;
+  else if (jsvIsStringEqual(op,"mul")) o = VECOP_MUL;
+  else if (jsvIsStringEqual(op,"min")) o = VECOP_MIN;
+  else if (jsvIsStringEqual(op,"max")) o = VECOP_MAX;
+  else if (jsvIsStringEqual(op,"abs")) o = VECOP_ABS;
+  else if (jsvIsStringEqual(op,"clip")) o = VECOP_CLIP;
+  else {
+    jsExceptionHere(JSET_ERROR, "Unknown operation %q", op);
+    return;
+  }
+  JsVarFloat bValue = 0, cValue = 0;
+  bool bIsArray = false;
+  if (o==VECOP_CLIP) {
+    if (!jsvIsArray(b) || jsvGetArrayLength(b)!=2) {
+      jsExceptionHere(JSET_ERROR, "Third argument should be an array of [min,max], not %t", b);
+      return;
+    }
+    bValue = jsvGetFloatAndUnLock(jsvGetArrayItem(b, 0));
+    cValue = jsvGetFloatAndUnLock(jsvGetArrayItem(b, 1));
+  } else if (jsvIsArrayBuffer(b)) {
+    bIsArray = true;
+  } else if (o==VECOP_ABS || jsvIsNumeric(b)) {
+    bValue = jsvGetFloat(b);
+  } else {
+    jsExceptionHere(JSET_ERROR, "Third argument should be an array buffer or number, not %t", b);
+    return;
+  }
+
+  JsVarDataArrayBufferViewType dstType = dst->varData.arraybuffer.type;
+  JsVarDataArrayBufferViewType aType = a->varData.arraybuffer.type;
+  JsVarDataArrayBufferViewType bType = bIsArray ? b->varData.arraybuffer.type : ARRAYBUFFERVIEW_INT32;
+  /* If everything is an integer that fits in a JsVarInt we can work with
+   * integers, otherwise use floats. */
+#define VECOP_IS_INT(T) (!JSV_ARRAYBUFFER_IS_FLOAT(T) && ((T)&~ARRAYBUFFERVIEW_BIG_ENDIAN)!=ARRAYBUFFERVIEW_UINT32)
+  // range check first (this also rejects NaN and Infinity) so the cast is safe
+#define VECOP_IS_INT_VALUE(V) ((V)>=-2147483648.0 && (V)<=2147483647.0 && (V)==(JsVarFloat)(JsVarInt)(V))
+  bool useInt = VECOP_IS_INT(dstType) && VECOP_IS_INT(aType) &&
+                (bIsArray ? VECOP_IS_INT(bType) : VECOP_IS_INT_VALUE(bValue)) &&
+                VECOP_IS_INT_VALUE(cValue);
+#undef VECOP_IS_INT_VALUE
+#undef VECOP_IS_INT
+  // the range of values that the destination can hold
+  long long dstMin = 0, dstMax = 0;
+  if (!JSV_ARRAYBUFFER_IS_FLOAT(dstType)) {
+    int bits = 8*(int)JSV_ARRAYBUFFER_GET_SIZE(dstType);
+    if (JSV_ARRAYBUFFER_IS_SIGNED(dstType)) {
+      dstMin = -(1LL<<(bits-1));
+      dstMax = (1LL<<(bits-1))-1;
+    } else
+      dstMax = (1LL<<bits)-1;
+  }
+
+  JsvArrayBufferIterator itDst, itA, itB;
+  jsvArrayBufferIteratorNew(&itDst, dst, 0);
+  jsvArrayBufferIteratorNew(&itA, a, 0);
+  if (bIsArray) jsvArrayBufferIteratorNew(&itB, b, 0);
+  while (jsvArrayBufferIteratorHasElement(&itDst) &&
+         jsvArrayBufferIteratorHasElement(&itA) &&
+         (!bIsArray || jsvArrayBufferIteratorHasElement(&itB))) {
+    if (useInt) {
+      long long va = jsvArrayBufferIteratorGetIntegerValue(&itA);
+      long long vb = bIsArray ? jsvArrayBufferIteratorGetIntegerValue(&itB) : (long long)bValue;
+      long long r;
+      switch (o) {
+        case VECOP_ADD: r = va + vb; break;
+        case VECOP_SUB: r = va - vb; break;
+        case VECOP_MUL: r = va * vb; break;
+        case VECOP_MIN: r = va<vb ? va : vb; break;
+        case VECOP_MAX: r = va>vb ? va : vb; break;
+        case VECOP_ABS: r = va<0 ? -va : va; break;
+        default: r = va<vb ? vb : (va>(long long)cValue ? (long long)cValue : va); break; // clip
+      }
+      if (r<dstMin) r = dstMin;
+      if (r>dstMax) r = dstMax;
+      jsvArrayBufferIteratorSetIntegerValue(&itDst, (JsVarInt)r);
+    } else {
+      JsVarFloat va = jsvArrayBufferIteratorGetFloatValue(&itA);
+      JsVarFloat vb = bIsArray ? jsvArrayBufferIteratorGetFloatValue(&itB) : bValue;
+      JsVarFloat r;
+      switch (o) {
+        case VECOP_ADD: r = va + vb; break;
+        case VECOP_SUB: r = va - vb; break;
+        case VECOP_MUL: r = va * vb; break;
+        case VECOP_MIN: r = va<vb ? va : vb; break;
+        case VECOP_MAX: r = va>vb ? va : vb; break;
+        case VECOP_ABS: r = va<0 ? -va : va; break;
+        default: r = va<vb ? vb : (va>cValue ? cValue : va); break; // clip
+      }
+      if (!JSV_ARRAYBUFFER_IS_FLOAT(dstType)) {
+        if (r<(JsVarFloat)dstMin) r = (JsVarFloat)dstMin;
+        if (r>(JsVarFloat)dstMax) r = (JsVarFloat)dstMax;
+      }
+      jsvArrayBufferIteratorSetFloatValue(&itDst, r);
+    }
+    jsvArrayBufferIteratorNext(&itDst);
+    jsvArrayBufferIteratorNext(&itA);
+    if (bIsArray) jsvArrayBufferIteratorNext(&itB);
+  }
+  jsvArrayBufferIteratorFree(&itDst);
+  jsvArrayBufferIteratorFree(&itA);
+  if (bIsArray) jsvArrayBufferIteratorFree(&itB);
+}
+
 /*JSON{
   "type" : "staticmethod",
   "class" : "E",
@@ -19,241 +19,659 @@
 #include "jslex.h"
 #include "jsinteractive.h"
 
-/* TODO:
- *
- * Handling of 'global' flag especially
- * lastIndex support?
+/* Regular expressions are compiled once into a compact instruction program
+ * (stored in a hidden child of the RegExp object) which is then executed by a
+ * non-recursive Pike VM. Every character of the input is looked at only once,
+ * with at most one 'thread' per instruction, so matching takes time linear in
+ * the length of the input and needs a bounded amount of working memory. That
+ * comes from the stack if there's enough, or a flat string if not.
  */
 
 #define MAX_GROUPS 9
-#define NO_RANGE  256
+#define JS_REGEXP_PROGRAM_NAME JS_HIDDEN_CHAR_STR"rx"
+
+typedef enum {
+  RXOP_MATCH,  ///< Match found
+  RXOP_CHAR,   ///< RXOP_CHAR, ch : match a single character
+  RXOP_ANY,    ///< match any character
+  RXOP_CLASS,  ///< RXOP_CLASS, 32 byte bitmap : match any character in the set
+  RXOP_BOL,    ///< must be at the start of the string
+  RXOP_EOL,    ///< must be at the end of the string
+  RXOP_SAVE,   ///< RXOP_SAVE, slot : store the current position in a capture slot
+  RXOP_JMP,    ///< RXOP_JMP, rel16 : jump
+  RXOP_SPLIT,  ///< RXOP_SPLIT, rel16, rel16 : try both (first has priority)
+} RegExpOp;
+
+#define RX_CLASS_BYTES 32
+#define RX_JMP_SIZE 3
+#define RX_SPLIT_SIZE 5
+#define RX_MAX_PROGRAM 32767 // relative jumps are 16 bit
+
+// Program header - thread count (16 bit), instruction count (16 bit), group count, flags
+#define RX_HEADER_SIZE 6
+#define RX_HEADER_FLAGS 5
+#define RX_FLAG_IGNORECASE 1
 
 typedef struct {
-  JsVar *sourceStr;
-  size_t startIndex;
+  const char *re;      ///< regex source (null terminated)
+  unsigned char *code; ///< output buffer, or 0 if we're only working out the size
+  size_t len;          ///< current length of the program
+  int insts;           ///< number of instructions
+  int threads;         ///< number of instructions a thread can wait at (ones that consume a character, and MATCH)
+  int groups;          ///< number of capturing groups
   bool ignoreCase;
-  bool rangeMatch;
-  short rangeFirstChar;
-  int groups;
-  size_t groupStart[MAX_GROUPS];
-  size_t groupEnd[MAX_GROUPS];
-} matchInfo;
+} RegExpCompiler;
 
-static JsVar *matchhere(char *regexp, JsvStringIterator *txtIt, matchInfo info);
+static void rxEmit(RegExpCompiler *rc, unsigned char b) {
+  if (rc->code) rc->code[rc->len] = b;
+  rc->len++;
+}
 
-static JsVar *matchfound(JsvStringIterator *txtIt, matchInfo info) {
-  JsVar *rmatch = jsvNewEmptyArray();
-  size_t endIndex = jsvStringIteratorGetIndex(txtIt);
-  JsVar *matchStr = jsvNewFromStringVar(info.sourceStr, info.startIndex, endIndex-info.startIndex);
-  jsvSetArrayItem(rmatch, 0, matchStr);
-  jsvUnLock(matchStr);
-  int i;
-  for (i=0;i<info.groups;i++) {
-    matchStr = jsvNewFromStringVar(info.sourceStr, info.groupStart[i], info.groupEnd[i]-info.groupStart[i]);
-    jsvSetArrayItem(rmatch, i+1, matchStr);
-    jsvUnLock(matchStr);
+static void rxSetRel(RegExpCompiler *rc, size_t at, size_t from, size_t to) {
+  if (!rc->code) return;
+  int rel = (int)to - (int)from;
+  rc->code[at] = (unsigned char)(rel&255);
+  rc->code[at+1] = (unsigned char)((rel>>8)&255);
+}
+
+static ALWAYS_INLINE int rxGetRel(const unsigned char *code) {
+  return (int16_t)(code[0] | (code[1]<<8));
+}
+
+/// Insert a SPLIT at 'at' (in front of an atom), with the given targets
+static void rxInsertSplit(RegExpCompiler *rc, size_t at, size_t first, size_t second) {
+  if (rc->code) {
+    memmove(&rc->code[at+RX_SPLIT_SIZE], &rc->code[at], rc->len-at);
+    rc->code[at] = RXOP_SPLIT;
   }
-  jsvObjectSetChildAndUnLock(rmatch, "index", jsvNewFromInteger((JsVarInt)info.startIndex));
-  jsvObjectSetChild(rmatch, "input", info.sourceStr);
+  rc->len += RX_SPLIT_SIZE;
+  rc->insts++;
+  rxSetRel(rc, at+1, at, first);
+  rxSetRel(rc, at+3, at, second);
+}
 
-  return rmatch;
+static void rxClassSet(unsigned char *set, unsigned char ch) {
+  set[ch>>3] |= (unsigned char)(1<<(ch&7));
 }
 
-// No match found, so search to end of regex to see if there's an '|'
-static JsVar *nomatchfound(char *regexp, matchInfo info) {
-  if (!jspCheckStackPosition()) return 0;
-  // TODO: | inside a group?
-  while (*regexp && *regexp!='|') {
-    if (*regexp=='\\') {
-      regexp++; // end of regex after escape char!
-      if (!*regexp) return 0;
+static void rxClassSetRange(unsigned char *set, unsigned char from, unsigned char to) {
+  int i;
+  for (i=from;i<=to;i++) rxClassSet(set, (unsigned char)i);
+}
+
+/** Parse an escape (rc->re points after the '\'). Returns the character code,
+ * or -1 if it was a character class like \d, in which case it's added to 'set' */
+static int rxParseEscape(RegExpCompiler *rc, unsigned char *set) {
+  char cH = *(rc->re++);
+  // missing quite a few here
+  // https://developer.mozilla.org/en-US/docs/Web/JavaScript/Guide/Regular_Expressions
+  switch (cH) {
+    case 'd': rxClassSetRange(set, '0', '9'); return -1;
+    case 'w': rxClassSetRange(set, '0', '9');
+              rxClassSetRange(set, 'a', 'z');
+              rxClassSetRange(set, 'A', 'Z');
+              rxClassSet(set, '_'); return -1;
+    case 's': rxClassSetRange(set, 0x09, 0x0D);
+              rxClassSet(set, ' '); return -1;
+    case 'D': case 'W': case 'S': { // inverse of the lowercase versions
+      unsigned char inv[RX_CLASS_BYTES];
+      memset(inv, 0, sizeof(inv));
+      const char lower[2] = { jsvStringCharToLower(cH), 0 };
+      const char *re = rc->re;
+      rc->re = lower;
+      rxParseEscape(rc, inv);
+      rc->re = re;
+      int i;
+      for (i=0;i<RX_CLASS_BYTES;i++) set[i] |= (unsigned char)~inv[i];
+      return -1;
     }
-    regexp++;
+    case 'f': return 0x0C;
+    case 'n': return 0x0A;
+    case 'r': return 0x0D;
+    case 't': return 0x09;
+    case 'v': return 0x0B;
+    case 'x':
+      if (rc->re[0] && rc->re[1]) {
+        cH = (char)hexToByte(rc->re[0],rc->re[1]);
+        rc->re += 2;
+      }
+      return (unsigned char)cH;
+    case 0:
+      rc->re--; // end of regex after escape char!
+      return '\\';
+    default:
+      if (cH>='0' && cH<='9') return cH-'0';
+      // fallback to the quoted character (e.g. /,-,? etc.)
+      return (unsigned char)cH;
   }
-  if (*regexp != '|') return 0;
-  regexp++;
-
-  JsvStringIterator txtIt;
-  jsvStringIteratorNew(&txtIt,  info.sourceStr, info.startIndex);
-  JsVar *rmatch = matchhere(regexp, &txtIt, info);
-  jsvStringIteratorFree(&txtIt);
-  return rmatch;
 }
 
-/* match: search for regexp anywhere in text */
-static JsVar *match(char *regexp, JsVar *str, size_t startIndex, bool ignoreCase) {
-  matchInfo info;
-  info.sourceStr = str;
-  info.startIndex = startIndex;
-  info.ignoreCase = ignoreCase;
-  info.rangeMatch = false;
-  info.rangeFirstChar = NO_RANGE;
-  info.groups = 0;
-
-  JsVar *rmatch;
-  JsvStringIterator txtIt, txtIt2;
-  jsvStringIteratorNew(&txtIt, str, startIndex);
-  /* must look even if string is empty */
-  jsvStringIteratorClone(&txtIt2, &txtIt);
-  rmatch = matchhere(regexp, &txtIt2, info);
-  jsvStringIteratorFree(&txtIt2);
-  jsvStringIteratorNext(&txtIt);
-  while (!rmatch && jsvStringIteratorHasChar(&txtIt)) {
-    info.startIndex++;
-    jsvStringIteratorClone(&txtIt2, &txtIt);
-    rmatch = matchhere(regexp, &txtIt2, info);
-    jsvStringIteratorFree(&txtIt2);
-    jsvStringIteratorNext(&txtIt);
+/// Parse a character set (rc->re points after the '[') into a bitmap
+static bool rxParseClass(RegExpCompiler *rc, unsigned char *set) {
+  bool inverted = rc->re[0]=='^';
+  if (inverted) rc->re++;
+  while (rc->re[0] && rc->re[0]!=']') {
+    int ch;
+    if (rc->re[0]=='\\') {
+      rc->re++;
+      ch = rxParseEscape(rc, set);
+    } else
+      ch = (unsigned char)*(rc->re++);
+    if (ch>=0 && rc->re[0]=='-' && rc->re[1] && rc->re[1]!=']') { // Character set range
+      rc->re++;
+      int chTo;
+      if (rc->re[0]=='\\') {
+        rc->re++;
+        chTo = rxParseEscape(rc, set);
+      } else
+        chTo = (unsigned char)*(rc->re++);
+      if (chTo<0) { // something like [a-\d] - '-' is a literal
+        rxClassSet(set, (unsigned char)ch);
+        rxClassSet(set, '-');
+      } else if (ch<=chTo)
+        rxClassSetRange(set, (unsigned char)ch, (unsigned char)chTo);
+    } else if (ch>=0)
+      rxClassSet(set, (unsigned char)ch);
   }
-  jsvStringIteratorFree(&txtIt);
-  return rmatch;
+  if (rc->re[0]!=']') {
+    jsExceptionHere(JSET_ERROR, "Unfinished character set in RegEx");
+    return false;
+  }
+  rc->re++;
+  if (rc->ignoreCase) {
+    int i;
+    for (i='a';i<='z';i++) {
+      if (set[i>>3]&(1<<(i&7))) rxClassSet(set, (unsigned char)(i-32));
+      if (set[(i-32)>>3]&(1<<((i-32)&7))) rxClassSet(set, (unsigned char)i);
+    }
+  }
+  if (inverted) {
+    int i;
+    for (i=0;i<RX_CLASS_BYTES;i++) set[i] = (unsigned char)~set[i];
+  }
+  return true;
+}
+
+static void rxEmitClass(RegExpCompiler *rc, const unsigned char *set) {
+  rxEmit(rc, RXOP_CLASS);
+  int i;
+  for (i=0;i<RX_CLASS_BYTES;i++) rxEmit(rc, set[i]);
+  rc->insts++;
+  rc->threads++;
+}
+
+static void rxEmitChar(RegExpCompiler *rc, int ch) {
+  if (rc->ignoreCase) ch = jsvStringCharToLower((char)ch);
+  rxEmit(rc, RXOP_CHAR);
+  rxEmit(rc, (unsigned char)ch);
+  rc->insts++;
+  rc->threads++;
 }
 
-/* Match one character. Doesn't modify txtIt, returns length of regexp char in *length  */
-bool matchcharacter(char *regexp, JsvStringIterator *txtIt, int *length, matchInfo *info) {
-  *length = 1;
-  char ch = jsvStringIteratorGetChar(txtIt);
-  if (regexp[0]=='.') return true;
-  if (regexp[0]=='[') { // Character set (any char inside '[]')
-    info->rangeMatch = true;
-    bool inverted = regexp[1]=='^';
-    if (inverted) (*length)++;
-    bool matchAny = false;
-    while (regexp[*length] && regexp[*length]!=']') {
-      int matchLen;
-      matchAny |= matchcharacter(&regexp[*length], txtIt, &matchLen, info);
-      (*length) += matchLen;
+static bool rxCompileAlternatives(RegExpCompiler *rc);
+
+/// Compile a single atom (and any quantifier after it)
+static bool rxCompileAtom(RegExpCompiler *rc) {
+  size_t atomStart = rc->len;
+  char ch = *(rc->re++);
+  if (ch=='^' || ch=='$') { // can't have a quantifier
+    rxEmit(rc, (ch=='^') ? RXOP_BOL : RXOP_EOL);
+    rc->insts++;
+    return true;
+  } else if (ch=='(') {
+    int group = -1;
+    if (rc->re[0]=='?' && rc->re[1]==':') { // non-capturing group
+      rc->re += 2;
+    } else if (rc->groups<MAX_GROUPS) {
+      group = ++rc->groups;
+      rxEmit(rc, RXOP_SAVE);
+      rxEmit(rc, (unsigned char)(group*2));
+      rc->insts++;
     }
-    if (regexp[*length]==']') {
-      (*length)++;
-    } else {
-      jsExceptionHere(JSET_ERROR, "Unfinished character set in RegEx");
+    if (!jspCheckStackPosition()) return false;
+    if (!rxCompileAlternatives(rc)) return false;
+    if (rc->re[0]!=')') {
+      jsExceptionHere(JSET_ERROR, "Unfinished group in RegEx");
       return false;
     }
-    info->rangeMatch = false;
-    return matchAny != inverted;
-  }
-  char cH = regexp[0];
-  if (cH=='\\') { // escape character
-    *length = 2;
-    // fallback to the quoted character (e.g. /,-,? etc.)
-    cH = regexp[1];
-    // missing quite a few here
-    // https://developer.mozilla.org/en-US/docs/Web/JavaScript/Guide/Regular_Expressions
-    if (cH=='d') return isNumeric(ch);
-    if (cH=='D') return !isNumeric(ch);
-    if (cH=='f') { cH=0x0C; goto haveCode; }
-    if (cH=='n') { cH=0x0A; goto haveCode; }
-    if (cH=='r') { cH=0x0D; goto haveCode; }
-    if (cH=='s') return isWhitespace(ch);
-    if (cH=='S') return !isWhitespace(ch);
-    if (cH=='t') { cH=0x09; goto haveCode; }
-    if (cH=='v') { cH=0x0B; goto haveCode; }
-    if (cH=='w') return isNumeric(ch) || isAlpha(ch) || ch=='_';
-    if (cH=='W') return !(isNumeric(ch) || isAlpha(ch) || ch=='_');
-    if (cH>='0' && cH<='9') { cH-='0'; goto haveCode; }
-    if (cH=='x' && regexp[2] && regexp[3]) {
-      *length = 4;
-      cH = (char)hexToByte(regexp[2],regexp[3]);
-      goto haveCode;
+    rc->re++;
+    if (group>0) {
+      rxEmit(rc, RXOP_SAVE);
+      rxEmit(rc, (unsigned char)(group*2+1));
+      rc->insts++;
     }
+  } else if (ch=='.') {
+    rxEmit(rc, RXOP_ANY);
+    rc->insts++;
+    rc->threads++;
+  } else if (ch=='[' || ch=='\\') {
+    unsigned char set[RX_CLASS_BYTES];
+    memset(set, 0, sizeof(set));
+    if (ch=='[') {
+      if (!rxParseClass(rc, set)) return false;
+      rxEmitClass(rc, set);
+    } else {
+      int code = rxParseEscape(rc, set);
+      if (code<0) rxEmitClass(rc, set);
+      else rxEmitChar(rc, code);
+    }
+  } else {
+    rxEmitChar(rc, (unsigned char)ch);
   }
-haveCode:
-  if (info->rangeMatch && regexp[*length] == '-') { // Character set range start
-    info->rangeFirstChar = cH;
-    (*length)++;
-    int matchLen;
-    bool match = matchcharacter(&regexp[*length], txtIt, &matchLen, info);
-    (*length)+=matchLen;
-    return match;
+  // Now handle any quantifier
+  char op = rc->re[0];
+  if (op!='*' && op!='+' && op!='?') return true;
+  rc->re++;
+  bool lazy = rc->re[0]=='?';
+  if (lazy) rc->re++;
+  size_t atomEnd = rc->len;
+  if (op=='*') {
+    // L1: SPLIT L2, L3; L2: atom; JMP L1; L3:
+    rxInsertSplit(rc, atomStart, atomStart+RX_SPLIT_SIZE, atomEnd+RX_SPLIT_SIZE+RX_JMP_SIZE);
+    size_t jmp = rc->len;
+    rxEmit(rc, RXOP_JMP);
+    rxEmit(rc, 0);
+    rxEmit(rc, 0);
+    rc->insts++;
+    rxSetRel(rc, jmp+1, jmp, atomStart);
+  } else if (op=='+') {
+    // L1: atom; SPLIT L1, L2; L2:
+    size_t split = rc->len;
+    rxEmit(rc, RXOP_SPLIT);
+    rxEmit(rc, 0); rxEmit(rc, 0);
+    rxEmit(rc, 0); rxEmit(rc, 0);
+    rc->insts++;
+    rxSetRel(rc, split+1, split, atomStart);
+    rxSetRel(rc, split+3, split, rc->len);
+  } else { // '?'
+    // SPLIT L1, L2; L1: atom; L2:
+    rxInsertSplit(rc, atomStart, atomStart+RX_SPLIT_SIZE, atomEnd+RX_SPLIT_SIZE);
   }
-  if (info->ignoreCase) {
-    ch = jsvStringCharToLower(ch);
-    cH = jsvStringCharToLower(cH);
+  if (lazy && rc->code) { // swap the priorities of the split
+    size_t split = (op=='+') ? rc->len-RX_SPLIT_SIZE : atomStart;
+    unsigned char t;
+    t = rc->code[split+1]; rc->code[split+1] = rc->code[split+3]; rc->code[split+3] = t;
+    t = rc->code[split+2]; rc->code[split+2] = rc->code[split+4]; rc->code[split+4] = t;
   }
-  if (info->rangeFirstChar != NO_RANGE) { // Character set range
-    char cL = (char)info->rangeFirstChar;
-    if (info->ignoreCase) {
-      cL = jsvStringCharToLower(cL);
+  return true;
+}
+
+/// Compile a set of alternatives separated by '|', up to ')' or the end of the regex
+static bool rxCompileAlternatives(RegExpCompiler *rc) {
+  size_t altStart = rc->len;
+  size_t pendingJmps = 0; // linked list of JMPs (position+1) that need to go to the end
+  while (true) {
+    while (rc->re[0] && rc->re[0]!='|' && rc->re[0]!=')') {
+      if (!rxCompileAtom(rc)) return false;
+      if (rc->len > RX_MAX_PROGRAM) {
+        jsExceptionHere(JSET_ERROR, "RegEx too complex");
+        return false;
+      }
+    }
+    if (rc->re[0]!='|') break;
+    rc->re++;
+    // SPLIT alternative, next; alternative; JMP end; next:
+    size_t jmp = rc->len;
+    rxEmit(rc, RXOP_JMP);
+    rxEmit(rc, (unsigned char)(pendingJmps&255));
+    rxEmit(rc, (unsigned char)(pendingJmps>>8));
+    rc->insts++;
+    rxInsertSplit(rc, altStart, altStart+RX_SPLIT_SIZE, rc->len+RX_SPLIT_SIZE);
+    pendingJmps = jmp+RX_SPLIT_SIZE+1;
+    altStart = rc->len;
+  }
+  // Now point all the JMPs at the end of the alternatives
+  if (rc->code) {
+    while (pendingJmps) {
+      size_t jmp = pendingJmps-1;
+      pendingJmps = rc->code[jmp+1] | (rc->code[jmp+2]<<8);
+      rxSetRel(rc, jmp+1, jmp, rc->len);
     }
-    info->rangeFirstChar = NO_RANGE;
-    return (ch >= cL && ch <= cH && cL < cH);
   }
-  return cH==ch;
+  return true;
 }
 
-/* matchhere: search for regexp at beginning of text. Only handles up to '|' character. Modifies txtIt */
-static JsVar *matchhere(char *regexp, JsvStringIterator *txtIt, matchInfo info) {
-  if (jspIsInterrupted()) return 0;
-  if (regexp[0] == '\0' || // end of regex
-      regexp[0] == '|') // end of this 'or' section of regex
-    return matchfound(txtIt, info);
-  if (regexp[0] == '^') { // must be beginning of String
-    if (jsvStringIteratorGetIndex(txtIt)!=0)
-      return 0; // no match
-    if (!jspCheckStackPosition()) return 0;
-    return matchhere(regexp+1, txtIt, info);
+/// Compile the given regex into a program. Returns false (and raises an exception) on error
+static bool rxCompile(RegExpCompiler *rc, const char *regex) {
+  rc->re = regex;
+  rc->len = RX_HEADER_SIZE;
+  rc->insts = 0;
+  rc->threads = 0;
+  rc->groups = 0;
+  if (!rxCompileAlternatives(rc)) return false;
+  if (rc->re[0]==')') {
+    jsExceptionHere(JSET_ERROR, "Unmatched ')' in RegEx");
+    return false;
   }
-  // Marker for end of String
-  if (regexp[0] == '$') {
-    if (!jsvStringIteratorHasChar(txtIt))
-      return matchhere(regexp+1, txtIt, info);
-    else
-      return nomatchfound(regexp+1, info); // not the end, it's a fail
+  rxEmit(rc, RXOP_MATCH);
+  rc->insts++;
+  rc->threads++;
+  if (rc->code) {
+    rc->code[0] = (unsigned char)(rc->threads&255);
+    rc->code[1] = (unsigned char)(rc->threads>>8);
+    rc->code[2] = (unsigned char)(rc->insts&255);
+    rc->code[3] = (unsigned char)(rc->insts>>8);
+    rc->code[4] = (unsigned char)rc->groups;
+    rc->code[RX_HEADER_FLAGS] = rc->ignoreCase ? RX_FLAG_IGNORECASE : 0;
   }
-  if (regexp[0] == '(') {
-    info.groupStart[info.groups] = jsvStringIteratorGetIndex(txtIt);
-    info.groupEnd[info.groups] = info.groupStart[info.groups];
-    if (info.groups<MAX_GROUPS) info.groups++;
-    if (!jspCheckStackPosition()) return 0;
-    return matchhere(regexp+1, txtIt, info);
+  return true;
+}
+
+/// Compile the source of a RegExp and store the program in it
+static JsVar *rxCompileAndStore(JsVar *parent, bool ignoreCase) {
+  JsVar *regex = jsvObjectGetChild(parent, "source", 0);
+  if (!jsvIsString(regex)) {
+    jsvUnLock(regex);
+    return 0;
   }
-  if (regexp[0] == ')') {
-    if (info.groups>0)
-      info.groupEnd[info.groups-1] = jsvStringIteratorGetIndex(txtIt);
-    if (!jspCheckStackPosition()) return 0;
-    return matchhere(regexp+1, txtIt, info);
+  size_t regexLen = jsvGetStringLength(regex);
+  // Copy the source onto the stack if there's room, or into a flat string if not
+  JsVar *regexVar = 0;
+  char *regexPtr;
+  if (jsuGetFreeStack() >= 512+regexLen) {
+    regexPtr = (char *)alloca(regexLen+1);
+  } else {
+    regexVar = jsvNewFlatStringOfLength((unsigned int)regexLen+1);
+    if (!regexVar) {
+      jsvUnLock(regex);
+      jsExceptionHere(JSET_ERROR, "Not enough memory to compile RegEx");
+      return 0;
+    }
+    regexPtr = jsvGetFlatStringPointer(regexVar);
   }
-  int charLength;
-  bool charMatched = matchcharacter(regexp, txtIt, &charLength, &info);
-  if (regexp[charLength] == '*' || regexp[charLength] == '+') {
-    char op = regexp[charLength];
-    if (!charMatched && op=='+') {
-      // with '+' operator it has to match at least once
-      return nomatchfound(&regexp[charLength+1], info);
+  jsvGetString(regex, regexPtr, regexLen+1);
+  jsvUnLock(regex);
+  // First pass works out the size, second writes the program
+  RegExpCompiler rc;
+  rc.code = 0;
+  rc.ignoreCase = ignoreCase;
+  JsVar *program = 0;
+  if (rxCompile(&rc, regexPtr)) {
+    // Compile straight into a flat string if we can, so match can run the program without copying it
+    program = jsvNewFlatStringOfLength((unsigned int)rc.len);
+    if (program) {
+      rc.code = (unsigned char *)jsvGetFlatStringPointer(program);
+      rxCompile(&rc, regexPtr);
+    } else if (jsuGetFreeStack() >= 512+rc.len) {
+      rc.code = (unsigned char *)alloca(rc.len);
+      rxCompile(&rc, regexPtr);
+      program = jsvNewStringOfLength((unsigned int)rc.len, (char*)rc.code);
     }
-    char *regexpAfterStar = regexp+charLength+1;
-    JsvStringIterator txtIt2;
-    // Try and match everything after right now
-    jsvStringIteratorClone(&txtIt2, txtIt);
-    JsVar *lastrmatch = matchhere(regexpAfterStar, &txtIt2, info);
-    jsvStringIteratorFree(&txtIt2);
-    // Otherwise try and match more than one
-    while (jsvStringIteratorHasChar(txtIt) && charMatched) {
-      // We had this character matched, so move on and see if we can match with the new one
-      jsvStringIteratorNext(txtIt);
-      charMatched = matchcharacter(regexp, txtIt, &charLength, &info);
-      // See if we can match after the character...
-      jsvStringIteratorClone(&txtIt2, txtIt);
-      JsVar *rmatch = matchhere(regexpAfterStar, &txtIt2, info);
-      jsvStringIteratorFree(&txtIt2);
-      // can't match with this - use the last one
-      if (rmatch) {
-        jsvUnLock(lastrmatch);
-        lastrmatch = rmatch;
+    if (!program)
+      jsExceptionHere(JSET_ERROR, "Not enough memory to compile RegEx");
+  }
+  jsvUnLock(regexVar);
+  if (!program) return 0;
+  jsvObjectSetChild(parent, JS_REGEXP_PROGRAM_NAME, program);
+  return program;
+}
+
+typedef struct {
+  unsigned short pc;
+  signed char slot;  ///< if >=0, this entry restores capture slot 'slot' to 'value' rather than following pc
+  uint32_t value;
+} RegExpStackEntry;
+
+typedef struct {
+  int count;
+  unsigned short *pc;
+  unsigned char *caps; ///< count*capsBytes of capture positions
+} RegExpThreadList;
+
+typedef struct {
+  const unsigned char *code;
+  int nslots;              ///< capture slots per thread
+  bool wideCaps;           ///< capture positions are 32 bit rather than 16 bit (only needed for very long strings)
+  size_t capsBytes;        ///< size of one thread's capture positions
+  size_t startIndex;       ///< capture positions are stored relative to this, plus one (so 0 means 'not set')
+  unsigned char *marks;    ///< generation each instruction was last added to a list in
+  unsigned char generation;
+  RegExpStackEntry *stack; ///< explicit stack for following non-consuming instructions
+} RegExpVM;
+
+static ALWAYS_INLINE uint32_t rxGetCap(RegExpVM *vm, const unsigned char *caps, int slot) {
+  if (vm->wideCaps) return ((const uint32_t*)caps)[slot];
+  return ((const uint16_t*)caps)[slot];
+}
+
+static ALWAYS_INLINE void rxSetCap(RegExpVM *vm, unsigned char *caps, int slot, uint32_t value) {
+  if (vm->wideCaps) ((uint32_t*)caps)[slot] = value;
+  else ((uint16_t*)caps)[slot] = (uint16_t)value;
+}
+
+/// Convert a position in the string to what we store in a capture slot
+static ALWAYS_INLINE uint32_t rxPosToCap(RegExpVM *vm, size_t pos) {
+  return (uint32_t)(pos + 1 - vm->startIndex);
+}
+
+/** Add the thread at 'startPc' to 'list', following all the instructions that
+ * don't consume a character. Uses an explicit stack rather than recursion, and
+ * each instruction is visited at most once per generation (pushing at most 2
+ * entries) so the stack is bounded by the program size. 'caps' is modified, but
+ * is restored on exit. */
+static void rxAddThread(RegExpVM *vm, RegExpThreadList *list, unsigned short startPc, unsigned char *caps, size_t pos, bool atEnd) {
+  int sp = 0;
+  vm->stack[sp].pc = startPc;
+  vm->stack[sp].slot = -1;
+  sp++;
+  while (sp) {
+    sp--;
+    if (vm->stack[sp].slot>=0) {
+      rxSetCap(vm, caps, vm->stack[sp].slot, vm->stack[sp].value);
+      continue;
+    }
+    unsigned short pc = vm->stack[sp].pc;
+    if (vm->marks[pc]==vm->generation) continue;
+    vm->marks[pc] = vm->generation;
+    const unsigned char *op = &vm->code[pc];
+    switch (op[0]) {
+      case RXOP_JMP:
+        vm->stack[sp].pc = (unsigned short)(pc+rxGetRel(&op[1]));
+        vm->stack[sp++].slot = -1;
+        break;
+      case RXOP_SPLIT: // push the second first, so the first gets handled first
+        vm->stack[sp].pc = (unsigned short)(pc+rxGetRel(&op[3]));
+        vm->stack[sp++].slot = -1;
+        vm->stack[sp].pc = (unsigned short)(pc+rxGetRel(&op[1]));
+        vm->stack[sp++].slot = -1;
+        break;
+      case RXOP_SAVE:
+        if (op[1]<vm->nslots) {
+          vm->stack[sp].slot = (signed char)op[1];
+          vm->stack[sp++].value = rxGetCap(vm, caps, op[1]);
+          rxSetCap(vm, caps, op[1], rxPosToCap(vm, pos));
+        }
+        vm->stack[sp].pc = (unsigned short)(pc+2);
+        vm->stack[sp++].slot = -1;
+        break;
+      case RXOP_BOL:
+        if (pos==0) {
+          vm->stack[sp].pc = (unsigned short)(pc+1);
+          vm->stack[sp++].slot = -1;
+        }
+        break;
+      case RXOP_EOL:
+        if (atEnd) {
+          vm->stack[sp].pc = (unsigned short)(pc+1);
+          vm->stack[sp++].slot = -1;
+        }
+        break;
+      default: { // consumes a character (or matches) - add to the list
+        int n = list->count++;
+        list->pc[n] = pc;
+        memcpy(&list->caps[(size_t)n*vm->capsBytes], caps, vm->capsBytes);
       }
     }
-    return lastrmatch;
   }
+}
+
+static void rxNextGeneration(RegExpVM *vm, size_t codeLen) {
+  vm->generation++;
+  if (!vm->generation) { // wrapped - clear marks
+    memset(vm->marks, 0, codeLen);
+    vm->generation = 1;
+  }
+}
+
+static JsVar *matchfound(RegExpVM *vm, JsVar *str, unsigned char *caps, int groups) {
+  JsVar *rmatch = jsvNewEmptyArray();
+  if (!rmatch) return 0;
+  size_t matchStart = vm->startIndex+rxGetCap(vm, caps, 0)-1;
+  size_t matchEnd = vm->startIndex+rxGetCap(vm, caps, 1)-1;
+  JsVar *matchStr = jsvNewFromStringVar(str, matchStart, matchEnd-matchStart);
+  jsvSetArrayItem(rmatch, 0, matchStr);
+  jsvUnLock(matchStr);
+  int i;
+  for (i=1;i<=groups;i++) {
+    uint32_t start = rxGetCap(vm, caps, i*2), end = rxGetCap(vm, caps, i*2+1);
+    if (start && end && end>=start) {
+      matchStr = jsvNewFromStringVar(str, vm->startIndex+start-1, end-start);
+      jsvSetArrayItem(rmatch, i, matchStr);
+      jsvUnLock(matchStr);
+    } // else group didn't take part in the match, so leave it undefined
+  }
+  jsvSetArrayLength(rmatch, groups+1, false);
+  jsvObjectSetChildAndUnLock(rmatch, "index", jsvNewFromInteger((JsVarInt)matchStart));
+  jsvObjectSetChild(rmatch, "input", str);
+  return rmatch;
+}
+
+/* match: run the compiled program for a match anywhere in text, from startIndex */
+static JsVar *match(JsVar *program, JsVar *str, size_t startIndex) {
+  unsigned char header[RX_HEADER_SIZE];
+  jsvGetStringChars(program, 0, (char*)header, RX_HEADER_SIZE);
+  int threads = header[0] | (header[1]<<8);
+  int insts = header[2] | (header[3]<<8);
+  int groups = header[4];
+  bool ignoreCase = (header[RX_HEADER_FLAGS] & RX_FLAG_IGNORECASE)!=0;
+  // If the program is all in one place (it's normally a flat string) we run it directly
+  size_t progLen;
+  const unsigned char *prog = (const unsigned char*)jsvGetDataPointer(program, &progLen);
+  if (!prog) progLen = jsvGetStringLength(program);
+  size_t codeLen = progLen-RX_HEADER_SIZE;
+  size_t strLen = jsvGetStringLength(str);
+
+  RegExpVM vm;
+  vm.nslots = (groups+1)*2;
+  vm.startIndex = startIndex;
+  vm.wideCaps = strLen >= startIndex+0xFFFF;
+  vm.capsBytes = (vm.wideCaps ? sizeof(uint32_t) : sizeof(uint16_t))*(size_t)vm.nslots;
+  size_t stackSize = (size_t)insts*2+1;
+  // Work out how much memory we need - biggest alignment first
+  size_t stackBytes = stackSize*sizeof(RegExpStackEntry);
+  size_t listCapsBytes = (size_t)threads*vm.capsBytes;
+  size_t listPcBytes = (size_t)threads*sizeof(unsigned short);
+  size_t needed = stackBytes + 2*listCapsBytes + 2*vm.capsBytes +
+                  2*listPcBytes + codeLen + (prog ? 0 : progLen);
+  /* Use the stack for working space if we can, or a flat string if
+   * there isn't enough stack */
+  JsVar *workVar = 0;
+  unsigned char *work;
+  if (jsuGetFreeStack() >= 512+needed) {
+    work = (unsigned char*)alloca(needed);
+  } else {
+    workVar = jsvNewFlatStringOfLength((unsigned int)needed);
+    if (!workVar) {
+      jsExceptionHere(JSET_ERROR, "Not enough memory to run RegEx");
+      return 0;
+    }
+    work = (unsigned char*)jsvGetFlatStringPointer(workVar);
+  }
+  vm.stack = (RegExpStackEntry*)work;
+  work += stackBytes;
+  RegExpThreadList lists[2];
+  int i;
+  for (i=0;i<2;i++) {
+    lists[i].count = 0;
+    lists[i].caps = work;
+    work += listCapsBytes;
+  }
+  unsigned char *caps = work;
+  work += vm.capsBytes;
+  unsigned char *matchCaps = work;
+  work += vm.capsBytes;
+  for (i=0;i<2;i++) {
+    lists[i].pc = (unsigned short*)work;
+    work += listPcBytes;
+  }
+  vm.marks = work;
+  memset(vm.marks, 0, codeLen);
+  vm.generation = 1;
+  work += codeLen;
+  if (!prog) { // not all in one place - copy it
+    jsvGetStringChars(program, 0, (char*)work, progLen);
+    prog = work;
+  }
+  const unsigned char *code = &prog[RX_HEADER_SIZE];
+  vm.code = code;
+  bool matched = false;
 
-  // This character is matched
-  if (jsvStringIteratorHasChar(txtIt) && charMatched) {
-    jsvStringIteratorNext(txtIt);
-    if (!jspCheckStackPosition()) return 0;
-    return matchhere(regexp+charLength, txtIt, info);
+  RegExpThreadList *clist = &lists[0];
+  RegExpThreadList *nlist = &lists[1];
+  size_t pos = startIndex;
+  JsvStringIterator txtIt;
+  jsvStringIteratorNew(&txtIt, str, startIndex);
+  /* must look even if string is empty */
+  while (true) {
+    bool atEnd = pos>=strLen;
+    // Start a new (lowest priority) thread here if we haven't got a match yet
+    if (!matched && (pos==startIndex || code[0]!=RXOP_BOL)) {
+      memset(caps, 0, vm.capsBytes);
+      rxSetCap(&vm, caps, 0, rxPosToCap(&vm, pos));
+      rxAddThread(&vm, clist, 0, caps, pos, atEnd);
+    }
+    if (!clist->count) {
+      // no threads left - if we can't start any more, we're done
+      if (matched || atEnd || code[0]==RXOP_BOL) break;
+    }
+    if (jspIsInterrupted()) break;
+    unsigned char ch = atEnd ? 0 : (unsigned char)jsvStringIteratorGetChar(&txtIt);
+    unsigned char chLower = ignoreCase ? (unsigned char)jsvStringCharToLower((char)ch) : ch;
+    bool nextAtEnd = pos+1>=strLen;
+    rxNextGeneration(&vm, codeLen);
+    nlist->count = 0;
+    int t;
+    for (t=0;t<clist->count;t++) {
+      unsigned short pc = clist->pc[t];
+      unsigned char *tcaps = &clist->caps[(size_t)t*vm.capsBytes];
+      const unsigned char *op = &code[pc];
+      bool charMatched = false;
+      switch (op[0]) {
+        case RXOP_MATCH:
+          matched = true;
+          memcpy(matchCaps, tcaps, vm.capsBytes);
+          rxSetCap(&vm, matchCaps, 1, rxPosToCap(&vm, pos));
+          t = clist->count; // cut off all lower priority threads
+          break;
+        case RXOP_CHAR:
+          charMatched = !atEnd && op[1]==chLower;
+          pc = (unsigned short)(pc+2);
+          break;
+        case RXOP_ANY:
+          charMatched = !atEnd;
+          pc = (unsigned short)(pc+1);
+          break;
+        case RXOP_CLASS:
+          charMatched = !atEnd && (op[1+(ch>>3)] & (1<<(ch&7)));
+          pc = (unsigned short)(pc+1+RX_CLASS_BYTES);
+          break;
+      }
+      if (charMatched) {
+        memcpy(caps, tcaps, vm.capsBytes);
+        rxAddThread(&vm, nlist, pc, caps, pos+1, nextAtEnd);
+      }
+    }
+    if (atEnd) break;
+    jsvStringIteratorNext(&txtIt);
+    pos++;
+    RegExpThreadList *tmp = clist;
+    clist = nlist;
+    nlist = tmp;
   }
-  // No match
-  return nomatchfound(&regexp[charLength], info);
+  jsvStringIteratorFree(&txtIt);
+  JsVar *rmatch = matched ? matchfound(&vm, str, matchCaps, groups) : 0;
+  jsvUnLock(workVar);
+  return rmatch;
 }
 
 /*JSON{
@@ -296,6 +714,13 @@ JsVar *jswrap_regexp_constructor(JsVar *str, JsVar *flags) {
       jsvObjectSetChild(r, "flags", flags);
   }
   jsvObjectSetChildAndUnLock(r, "lastIndex", jsvNewFromInteger(0));
+  // Compile now, so errors in the RegEx are reported straight away
+  JsVar *program = rxCompileAndStore(r, jswrap_regexp_hasFlag(r,'i'));
+  if (!program) {
+    jsvUnLock(r);
+    return 0;
+  }
+  jsvUnLock(program);
   return r;
 }
 
@@ -337,21 +762,19 @@ Or with groups `/W(o)rld/.exec("Hello World")` returns:
 JsVar *jswrap_regexp_exec(JsVar *parent, JsVar *arg) {
   JsVar *str = jsvAsString(arg);
   JsVarInt lastIndex = jsvGetIntegerAndUnLock(jsvObjectGetChild(parent, "lastIndex", 0));
-  JsVar *regex = jsvObjectGetChild(parent, "source", 0);
-  if (!jsvIsString(regex)) {
-    jsvUnLock2(str,regex);
-    return 0;
+  bool ignoreCase = jswrap_regexp_hasFlag(parent,'i');
+  JsVar *program = jsvObjectGetChild(parent, JS_REGEXP_PROGRAM_NAME, 0);
+  if (program && ((unsigned char)jsvGetCharInString(program, RX_HEADER_FLAGS)&RX_FLAG_IGNORECASE)!=ignoreCase) {
+    jsvUnLock(program); // flags changed - recompile
+    program = 0;
   }
-  size_t regexLen = jsvGetStringLength(regex);
-  char *regexPtr = (char *)alloca(regexLen+1);
-  if (!regexPtr) {
-    jsvUnLock2(str,regex);
+  if (!program) program = rxCompileAndStore(parent, ignoreCase);
+  if (!program) {
+    jsvUnLock(str);
     return 0;
   }
-  jsvGetString(regex, regexPtr, regexLen+1);
-  jsvUnLock(regex);
-  JsVar *rmatch = match(regexPtr, str, (size_t)lastIndex, jswrap_regexp_hasFlag(parent,'i'));
-  jsvUnLock(str);
+  JsVar *rmatch = match(program, str, (size_t)lastIndex);
+  jsvUnLock2(str,program);
   if (!rmatch) {
     rmatch = jsvNewWithFlags(JSV_NULL);
     lastIndex = 0;
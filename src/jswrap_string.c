@@ -160,9 +160,43 @@ Return the index of substring in this string, or -1 if not found
 }
 Return the last index of substring in this string, or -1 if not found
  */
+/** Search for substring in str, trying indices from idx towards end (exclusive)
+ * in steps of dir (1 or -1). Returns the index of the match, or -1. If both
+ * strings are stored contiguously (flat, native, or small enough to fit in one
+ * block) memchr/memcmp are used rather than comparing char by char. */
+static int jswrap_string_search(JsVar *str, JsVar *substring, int idx, int end, int dir) {
+  if (dir>0 ? idx>=end : idx<=end) return -1;
+  size_t strLen, subLen;
+  const char *strPtr = jsvGetDataPointer(str, &strLen);
+  const char *subPtr = strPtr ? jsvGetDataPointer(substring, &subLen) : 0;
+  if (strPtr && subPtr) {
+    if (!subLen) return idx;
+    char first = subPtr[0];
+    if (dir>0) {
+      while (idx<end) {
+        const char *p = (const char*)memchr(&strPtr[idx], first, (size_t)(end-idx));
+        if (!p) return -1;
+        idx = (int)(p-strPtr);
+        if (!memcmp(p+1, subPtr+1, subLen-1)) return idx;
+        idx++;
+      }
+    } else {
+      for (;idx>end;idx--)
+        if (strPtr[idx]==first && !memcmp(&strPtr[idx+1], subPtr+1, subLen-1))
+          return idx;
+    }
+    return -1;
+  }
+  // slow, but simple!
+  for (;idx!=end;idx+=dir) {
+    if (jsvCompareString(str, substring, (size_t)idx, 0, true)==0)
+      return idx;
+  }
+  return -1;
+}
+
 int jswrap_string_indexOf(JsVar *parent, JsVar *substring, JsVar *fromIndex, bool lastIndexOf) {
   if (!jsvIsString(parent)) return 0;
-  // slow, but simple!
   substring = jsvAsString(substring);
   if (!substring) return 0; // out of memory
   int parentLength = (int)jsvGetStringLength(parent);
@@ -193,14 +227,9 @@ int jswrap_string_indexOf(JsVar *parent, JsVar *substring, JsVar *fromIndex, boo
     }
   }
 
-  for (;idx!=end;idx+=dir) {
-    if (jsvCompareString(parent, substring, (size_t)idx, 0, true)==0) {
-      jsvUnLock(substring);
-      return idx;
-    }
-  }
+  idx = jswrap_string_search(parent, substring, idx, end, dir);
   jsvUnLock(substring);
-  return -1;
+  return idx;
 }
 
 /*JSON{
@@ -545,6 +574,20 @@ JsVar *jswrap_string_split(JsVar *parent, JsVar *split) {
   int splitlen = jsvIsUndefined(split) ? 0 : (int)jsvGetStringLength(split);
   int l = (int)jsvGetStringLength(parent) + 1 - splitlen;
 
+  if (splitlen>0) {
+    // search for each separator in turn rather than trying every index
+    while ((idx = jswrap_string_search(parent, split, last, l, 1)) >= 0) {
+      JsVar *part = jsvNewFromStringVar(parent, (size_t)last, (size_t)(idx-last));
+      if (!part) break; // out of memory
+      jsvArrayPushAndUnLock(array, part);
+      last = idx+splitlen;
+    }
+    if (idx<0) // add whatever remains after the last separator
+      jsvArrayPushAndUnLock(array, jsvNewFromStringVar(parent, (size_t)last, JSVAPPENDSTRINGVAR_MAXLENGTH));
+    jsvUnLock(split);
+    return array;
+  }
+
   for (idx=0;idx<=l;idx++) {
     if (splitlen==0 && idx==0) continue; // special case for where split string is ""
     if (idx==l || splitlen==0 || jsvCompareString(parent, split, (size_t)idx, 0, true)==0) {
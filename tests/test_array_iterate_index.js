@@ -0,0 +1,19 @@
+// Array iteration reuses the index var when the callback doesn't keep it
+var a = [5,6,7,8];
+var kept = [];
+a.forEach(function(v,i) { kept.push(i); });
+var fns = [];
+a.forEach(function(v,i) { fns.push(function() { return i; }); });
+var r1 = a.map(function(v,i) { return i; }).join();
+var r2 = kept.join();
+var r3 = fns.map(function(f) { return f(); }).join();
+var r4 = a.reduce(function(p,v,i) { return i; });
+var r5 = a.reduce(function(p,v,i) { return p+v*i; }, 0);
+var r6 = a.findIndex(function(v,i) { return v==7; });
+var r7 = [1,,3].map(function(x) { return x*2; });
+var r8 = new Uint8Array([3,4]).map(function(v,i) { return v*i; }).join();
+
+result = r1=="0,1,2,3" && r2=="0,1,2,3" && r3=="0,1,2,3" &&
+         r4==3 && r5==44 && r6==2 &&
+         r7.length==3 && r7[0]==2 && !(1 in r7) && r7[2]==6 &&
+         r8=="0,4";
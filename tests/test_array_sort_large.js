@@ -0,0 +1,38 @@
+// Sorting already-ordered Arrays used to be quadratic and recurse too deeply
+function isSorted(a, cmp) {
+  for (var i=1;i<a.length;i++)
+    if (cmp(a[i-1],a[i])>0) return false;
+  return true;
+}
+function num(a,b) { return a-b; }
+var N = 200;
+var sorted = [], reversed = [], dups = [], objs = [];
+for (var i=0;i<N;i++) {
+  sorted.push(i);
+  reversed.push(N-i);
+  dups.push(i%3);
+  objs.push({v:(i*37)%N});
+}
+sorted.sort(num);
+reversed.sort(num);
+dups.sort(num);
+objs.sort(function(a,b) { return a.v-b.v; });
+// fractional compare results shouldn't be rounded to 0
+var fracs = [0.5,0.1,0.9,0.3].sort(num);
+// the same object many times over
+var o = {};
+var same = [];
+for (i=0;i<40;i++) same.push(o);
+same.sort(function() { return 0; });
+// sparse arrays keep their holes where they were
+var sparse = [3,,1,,2].sort();
+// a compare function that changes the array mustn't break anything
+var mutated = [5,4,3,2,1,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20];
+mutated.sort(function(a,b) { mutated.length = 0; return a-b; });
+
+result = isSorted(sorted, num) && isSorted(reversed, num) &&
+  isSorted(dups, num) && isSorted(objs, function(a,b) { return a.v-b.v; }) &&
+  fracs=="0.1,0.3,0.5,0.9" &&
+  same.length==40 && same[39]===o &&
+  JSON.stringify(sparse)=="[1,null,2,null,3]" && sparse.length==5 &&
+  mutated.length==0;
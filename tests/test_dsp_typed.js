@@ -0,0 +1,32 @@
+// E.sum/variance/convolve/FFT give the same answers for typed arrays (fast path) and plain Arrays
+function close(a,b) { return Math.abs(a-b) <= 0.0001*Math.max(1,Math.abs(b)); }
+var N = 64;
+var f = new Float32Array(N), i16 = new Int16Array(N), u8 = new Uint8Array(N);
+for (var i=0;i<N;i++) {
+  f[i] = Math.sin(i/3)*3 + 0.5;
+  i16[i] = (i*97)%2000 - 1000;
+  u8[i] = (i*13)&255;
+}
+var ok = true;
+[f,i16,u8].forEach(function(a) {
+  var arr = [].slice.call(a);
+  ok = ok && close(E.sum(a), E.sum(arr)) &&
+    close(E.variance(a,3), E.variance(arr,3)) &&
+    close(E.convolve(a,a,5), E.convolve(arr,arr,5)) &&
+    close(E.convolve(a,a,-70), E.convolve(arr,arr,-70));
+});
+// view at an odd offset isn't aligned, so uses the normal code
+var odd = new Int16Array(new Uint8Array(N*2+1).buffer, 1, N);
+odd.set(i16);
+ok = ok && E.sum(odd)==E.sum(i16);
+
+// In-place real FFT matches the normal FFT
+var fft = new Float32Array(f);
+E.FFT(fft);
+var arr = [].slice.call(f);
+E.FFT(arr);
+for (i=0;i<N;i++) ok = ok && Math.abs(fft[i]-arr[i]) < 0.0001;
+var dc = new Float32Array([1,1,1,1]);
+E.FFT(dc);
+
+result = ok && dc=="1,0,0,0";
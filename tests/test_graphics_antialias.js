@@ -0,0 +1,51 @@
+// Anti-aliased lines, circles and native bezier curves
+var ok = true;
+function check(name, v) { if (!v) { console.log("Failed", name); ok = false; } }
+
+var g = Graphics.createArrayBuffer(32,32,8);
+g.setColor(255);
+// horizontal line on pixel centres: full intensity, ends half covered
+g.drawLineAA(2,4,12,4);
+function near(a,b) { return Math.abs(a-b)<=1; }
+check("hline", g.getPixel(5,4)==255 && g.getPixel(5,3)==0 && g.getPixel(5,5)==0 && near(g.getPixel(2,4),128) && near(g.getPixel(12,4),128));
+// between two rows: split between them
+g.clear().drawLineAA(2,6.5,12,6.5);
+check("half", near(g.getPixel(7,6),128) && near(g.getPixel(7,7),128));
+// 45 degrees lands on pixel centres
+g.clear().drawLineAA(0,0,10,10);
+check("diag", g.getPixel(5,5)==255 && g.getPixel(6,5)==0 && g.getPixel(5,6)==0);
+
+// circle - symmetrical, and about 2*PI*r worth of pixels in total
+g.clear().drawCircleAA(16,16,10);
+var sum = 0, sym = true;
+for (var y=0;y<32;y++) for (var x=0;x<32;x++) {
+  var c = g.getPixel(x,y);
+  sum += c;
+  if (c != g.getPixel(32-x,y) || c != g.getPixel(y,x)) sym = false;
+}
+check("circle", sym && g.getPixel(26,16)==255 && g.getPixel(16,16)==0 && Math.abs(sum/255 - 2*Math.PI*10) < 4);
+
+// blending with what's already there in 16 bit
+var g16 = Graphics.createArrayBuffer(16,16,16);
+g16.setColor(0,0,1).fillRect(0,0,15,15).setColor(1,0,0).drawLineAA(0,4.5,15,4.5);
+var px = g16.getPixel(8,4);
+check("blend16", (px>>11)>10 && (px>>11)<20 && (px&31)>10 && (px&31)<20);
+
+// below 4bpp we just get a normal line
+var a = Graphics.createArrayBuffer(16,16,1), b = Graphics.createArrayBuffer(16,16,1);
+a.drawLineAA(1,2,14,9); b.drawLine(1,2,14,9);
+check("1bpp", E.toString(a.buffer)==E.toString(b.buffer));
+
+// beziers - a straight 'curve' is just a line, curves hit both ends and bend towards the control point
+a = Graphics.createArrayBuffer(32,32,8); b = Graphics.createArrayBuffer(32,32,8);
+a.setColor(255).drawBezier([0,0,10,10,20,20]); b.setColor(255).drawLine(0,0,20,20);
+check("straight", E.toString(a.buffer)==E.toString(b.buffer));
+a.clear().drawBezier([2,30,16,-26,30,30]);
+check("quadratic", a.getPixel(2,30)==255 && a.getPixel(30,30)==255 && a.getPixel(16,2)==255 && a.getPixel(16,30)==0);
+a.clear().drawBezier([2,2,2,30,30,30,30,2], true);
+check("cubic", a.getPixel(2,2)>=120 && a.getPixel(30,2)>=120 && a.getPixel(16,22)+a.getPixel(16,23)>=200);
+var threw = false;
+try { a.drawBezier([1,2,3]); } catch (e) { threw = true; }
+check("bad args", threw);
+
+result = ok;
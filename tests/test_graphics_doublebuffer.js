@@ -0,0 +1,23 @@
+// Double-buffered ArrayBuffer Graphics - flip swaps buffers and sends frames in the background
+var file = "/tmp/espruino_test_frame.raw";
+require("fs").writeFileSync(file, "");
+var g = Graphics.createArrayBuffer(16,8,8,{doubleBuffer:true, output:file});
+var b1 = E.getAddressOf(g.buffer);
+g.setColor(1).fillRect(0,0,15,7); // whole frame
+var sent1 = false;
+g.flip().then(function() { sent1 = true; });
+var swapped = E.getAddressOf(g.buffer) != b1;
+// new back buffer starts as a copy of the last frame
+var copied = E.toString(g.buffer) == E.toString(new Uint8Array(128).fill(1));
+g.setColor(2).fillRect(2,3,5,4); // only this area should be sent
+var p = g.flip();
+var stats = g.getFlipStats();
+
+var ok = swapped && copied && stats.flips==2 && stats.bytes==128+8;
+p.then(function() {
+  var f = require("fs").readFileSync(file);
+  var expected = new Uint8Array(g.buffer);
+  result = ok && sent1 && f == E.toString(expected) &&
+           expected[3*16+2]==2 && expected[4*16+5]==2 && expected[5*16+5]==1;
+  require("fs").unlink(file);
+});
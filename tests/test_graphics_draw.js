@@ -0,0 +1,28 @@
+// Batched drawing with g.draw should match the individual calls
+function make() { return Graphics.createArrayBuffer(32,32,8); }
+function same(a,b) { return E.toString(a.buffer)==E.toString(b.buffer); }
+
+var a = make(), b = make();
+a.setColor(3).setBgColor(1);
+a.drawLine(0,0,31,20).moveTo(5,5).lineTo(20,8).lineTo(2,30);
+a.drawRect(10,10,20,20).fillRect(12,12,14,14).clearRect(13,13,13,13);
+a.drawEllipse(0,0,10,6).fillEllipse(20,0,30,8).drawCircle(16,16,5).fillCircle(25,25,3);
+a.setPixel(1,1).setPixel(2,2,7);
+a.drawPoly([0,31,5,25,10,31],true).fillPoly([20,31,25,22,30,31]);
+a.setColor(9).setPixel(3,3);
+
+b.draw([
+  ["color",3], ["bgColor",1],
+  ["line",0,0,31,20], ["moveTo",5,5], ["lineTo",20,8], ["lineTo",2,30],
+  ["rect",10,10,20,20], ["fillRect",12,12,14,14], ["clearRect",13,13,13,13],
+  ["ellipse",0,0,10,6], ["fillEllipse",20,0,30,8], ["circle",16,16,5], ["fillCircle",25,25,3],
+  ["pixel",1,1], ["pixel",2,2,7],
+  ["poly",[0,31,5,25,10,31],true], ["fillPoly",[20,31,25,22,30,31]],
+  ["color",9], ["pixel",3,3]
+]);
+
+var err;
+try { b.draw([["nope",1,2]]); } catch (e) { err = e; }
+
+result = same(a,b) && a.getColor()==b.getColor() && a.getBgColor()==b.getBgColor() &&
+         JSON.stringify(a.getModified())==JSON.stringify(b.getModified()) && err!==undefined;
@@ -0,0 +1,53 @@
+// drawImage straight into flat ArrayBuffers (blitRow) for various bpp
+var results = [];
+
+function check(g, fn) {
+  for (var y=0;y<g.getHeight();y++)
+    for (var x=0;x<g.getWidth();x++)
+      if (g.getPixel(x,y) != fn(x,y)) return false;
+  return true;
+}
+
+// 8 bit image onto 8 bit, transparent, partly off-screen
+var g = Graphics.createArrayBuffer(6,5,8);
+g.setBgColor(0x34).clear();
+var data = new Uint8Array(40);
+for (var i=0;i<12;i++) data[i] = i+1;
+g.drawImage({width:4,height:3,bpp:8,buffer:data.buffer,transparent:6}, -1, 3);
+results.push(check(g, function(x,y) {
+  var ix = x+1, iy = y-3;
+  if (ix<0 || ix>=4 || iy<0 || iy>=3) return 0x34;
+  var c = ix+iy*4+1;
+  return c==6 ? 0x34 : c;
+}));
+
+// 16 bit image onto 16 bit - image data is big endian
+g = Graphics.createArrayBuffer(6,5,16);
+g.setBgColor(0x1234).clear();
+var data16 = new Uint8Array([0x12,0x34, 0xAB,0xCD, 0xF8,0x00, 0x00,0x1F]);
+g.drawImage({width:2,height:2,bpp:16,buffer:data16.buffer}, 4, 0);
+results.push(g.getPixel(4,0)==0x1234 && g.getPixel(5,0)==0xABCD && g.getPixel(4,1)==0xF800 && g.getPixel(5,1)==0x001F && g.getPixel(3,0)==0x1234);
+
+// 1 bit image onto 16 bit uses fg/bg colours
+g.setColor(0xFFFF).setBgColor(0).clear();
+g.drawImage({width:6,height:2,bpp:1,buffer:new Uint8Array([0b10110010, 0b11110000]).buffer}, 0, 1);
+var bits = "101100101111";
+results.push(check(g, function(x,y) {
+  if (y<1 || y>2) return 0;
+  return bits[x+(y-1)*6]=="1" ? 0xFFFF : 0;
+}));
+
+// 1 bit image onto 1 bit, with a clip rectangle
+g = Graphics.createArrayBuffer(12,3,1,{msb:true});
+g.setClipRect(2,0,8,2);
+g.drawImage({width:12,height:2,bpp:1,buffer:new Uint8Array([0xFF,0xF0,0x00]).buffer}, 0, 0);
+results.push(check(g, function(x,y) { return (x>=2 && x<=8 && y==0) ? 1 : 0; }));
+
+// 2 bit image with a palette onto 16 bit
+g = Graphics.createArrayBuffer(4,2,16);
+var pal = new Uint16Array([0xF800,0x07E0,0x001F,0xFFFF]);
+g.drawImage({width:4,height:2,bpp:2,buffer:new Uint8Array([0b00011011,0b11100100]).buffer,palette:pal}, 0, 0);
+results.push(check(g, function(x,y) { return pal[y ? 3-x : x]; }));
+
+result = results.every(function(x){return x;});
+if (!result) console.log(results);
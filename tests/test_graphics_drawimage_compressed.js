@@ -0,0 +1,51 @@
+// Compressed images should draw exactly the same as uncompressed ones
+var hs = require("heatshrink");
+var ok = true;
+var seed = 1;
+function rnd() { seed = ((seed*69069)+1)>>>0; return seed>>>24; }
+
+function check(gbpp, ibpp, w, h, x, y, transparent, rotate) {
+  var data = new Uint8Array((w*h*ibpp+7)>>3);
+  for (var i=0;i<data.length;i++) data[i] = (i&3) ? rnd() : 0; // some runs for the compressor to find
+  var plain = {width:w, height:h, bpp:ibpp, buffer:data.buffer};
+  var packed = {width:w, height:h, bpp:ibpp, buffer:hs.compress(data.buffer), compressed:true};
+  if (transparent!==undefined) plain.transparent = packed.transparent = transparent;
+  var a = Graphics.createArrayBuffer(40,30,gbpp);
+  var b = Graphics.createArrayBuffer(40,30,gbpp);
+  if (rotate) { a.setRotation(1); b.setRotation(1); }
+  a.setColor(-1).fillRect(3,3,20,20);
+  b.setColor(-1).fillRect(3,3,20,20);
+  a.drawImage(plain, x, y);
+  b.drawImage(packed, x, y);
+  if (E.toString(a.buffer) != E.toString(b.buffer)) {
+    console.log("Mismatch", gbpp, ibpp, w, h, x, y, transparent, rotate);
+    ok = false;
+  }
+}
+
+[1,8,16].forEach(function(gbpp) {
+  [1,3,8,16].forEach(function(ibpp) {
+    check(gbpp, ibpp, 13, 9, 2, 3);
+    check(gbpp, ibpp, 13, 9, -5, 25); // clipped
+    check(gbpp, ibpp, 7, 11, 4, 1, 0);
+    check(gbpp, ibpp, 7, 11, 4, 1, undefined, true);
+  });
+});
+
+// String image format, read from Storage
+var img = Graphics.createArrayBuffer(24,10,1,{msb:true});
+img.drawString("Hi!", 1, 2);
+var str = E.toString(24, 10, 1|64, hs.compress(img.buffer));
+require("Storage").write("cimg", str);
+var a = Graphics.createArrayBuffer(30,20,8);
+var b = Graphics.createArrayBuffer(30,20,8);
+a.drawImage({width:24, height:10, buffer:img.buffer}, 3, 4);
+b.drawImage(require("Storage").read("cimg"), 3, 4);
+if (E.toString(a.buffer) != E.toString(b.buffer)) { console.log("Mismatch (String)"); ok = false; }
+require("Storage").erase("cimg");
+
+// Scaling isn't supported
+var threw = false;
+try { b.drawImage(str, 0, 0, {scale:2}); } catch (e) { threw = true; }
+
+result = ok && threw;
@@ -0,0 +1,15 @@
+// fillPoly with more than 64 edges crossing each scanline
+var g = Graphics.createArrayBuffer(200,20,8);
+g.clear();
+var p = [0,19];
+// 50 teeth, each 2px wide with a 2px gap => 100 edges cross every scanline
+for (var i=0;i<50;i++) p.push(i*4,0, i*4+2,0, i*4+2,19, i*4+4,19);
+g.fillPoly(p);
+var b = new Uint8Array(g.buffer);
+// every tooth should be filled on a scanline in the middle
+var y = 10, ok = true;
+for (i=0;i<50;i++) {
+  if (!b[y*200+i*4+1]) ok = false; // inside tooth
+  if (b[y*200+i*4+3]) ok = false; // in gap
+}
+result = ok;
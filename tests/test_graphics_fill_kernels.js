@@ -0,0 +1,40 @@
+// Check the flat ArrayBuffer fill/scroll kernels against getPixel for each bpp
+var results = [];
+
+function check(g, fn) {
+  for (var y=0;y<g.getHeight();y++)
+    for (var x=0;x<g.getWidth();x++)
+      if (g.getPixel(x,y) != fn(x,y)) return false;
+  return true;
+}
+
+[1,2,4,8,16,24].forEach(function(bpp) {
+  [{},{msb:true}].forEach(function(opt) {
+    [27,32].forEach(function(w) {
+      var g = Graphics.createArrayBuffer(w,10,bpp,opt);
+      var col = (1<<bpp)-2, bg = 1;
+      g.setBgColor(bg).clear();
+      results.push(check(g, function(x,y) { return bg; }));
+      // rectangle with unaligned ends
+      g.setColor(col).fillRect(3,2,w-5,6);
+      results.push(check(g, function(x,y) { return (x>=3 && x<=w-5 && y>=2 && y<=6) ? col : bg; }));
+      // horizontal and vertical lines
+      g.setColor(0).drawLine(w-1,8,1,8).drawLine(0,9,0,0);
+      results.push(check(g, function(x,y) {
+        if (x==0 || (y==8 && x>=1)) return 0;
+        return (x>=3 && x<=w-5 && y>=2 && y<=6) ? col : bg;
+      }));
+      // scroll right by 8 and up by 1 - the new area is filled with bg
+      g.scroll(8,-1);
+      results.push(check(g, function(x,y) {
+        if (x<8 || y==9) return bg;
+        x-=8; y+=1;
+        if (x==0 || (y==8 && x>=1)) return 0;
+        return (x>=3 && x<=w-5 && y>=2 && y<=6) ? col : bg;
+      }));
+    });
+  });
+});
+
+result = results.every(function(x){return x;});
+if (!result) console.log(results);
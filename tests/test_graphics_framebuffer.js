@@ -0,0 +1,19 @@
+// Linux framebuffer backend, using a plain file as a fake framebuffer
+var file = "/tmp/espruino_test_fb.raw";
+require("fs").writeFileSync(file, "");
+var g = Graphics.createFramebuffer(file, {width:8, height:4, bpp:8, doubleBuffer:true});
+var sizeOk = g.getWidth()==8 && g.getHeight()==4;
+// draws go into the back page (page 1), page 0 is on screen
+g.setColor(5).fillRect(0,0,7,3);
+g.flip();
+g.setColor(7).setPixel(2,1);
+g.flip();
+g.setColor(9).setPixel(3,2); // drawn into page 1, not flipped yet
+var f = require("fs").readFileSync(file);
+function page(n) { return f.substr(n*32, 32); }
+var expected0 = "\x05\x05\x05\x05\x05\x05\x05\x05" + "\x05\x05\x07\x05\x05\x05\x05\x05" + "\x05\x05\x05\x05\x05\x05\x05\x05" + "\x05\x05\x05\x05\x05\x05\x05\x05";
+var expected1 = expected0.substr(0,19) + "\x09" + expected0.substr(20);
+var stats = g.getFlipStats();
+result = sizeOk && f.length==64 && page(0)==expected0 && page(1)==expected1 &&
+         g.getPixel(3,2)==9 && stats.flips==2 && stats.bytes==32+1;
+require("fs").unlink(file);
@@ -0,0 +1,22 @@
+// Vector font glyph cache should give identical results to uncached rendering
+function render() {
+  var g = Graphics.createArrayBuffer(64,48,8), out = [];
+  for (var r=0;r<4;r++) {
+    g.setRotation(r, r&1); g.clear();
+    g.setFontVector(12).drawString("Ab9@",3,2).drawString("Ab9@",17,19);
+    g.setFontVector(20).drawString("xQ&",-3,30);
+    g.setFontAlign(-1,-1,1).drawString("hi",40,10).setFontAlign(-1,-1,0);
+    out.push(E.CRC32(g.buffer));
+  }
+  return out.join(",");
+}
+var uncached = render();
+Graphics.setGlyphCacheSize(1000);
+var first = render(), second = render();
+var stats = Graphics.getGlyphCacheStats();
+Graphics.setGlyphCacheSize(0);
+var off = Graphics.getGlyphCacheStats();
+
+result = uncached==first && uncached==second &&
+         stats.size==1000 && stats.hits>0 && stats.misses>0 && stats.used<=1000 &&
+         off.size==0 && off.used==0;
@@ -0,0 +1,50 @@
+// Graphics.getModifiedRegions - multiple separate modified areas
+var g = Graphics.createArrayBuffer(64,64,8);
+var r, s, results = [];
+
+// two small areas in opposite corners stay separate
+g.getModifiedRegions(true);
+g.fillRect(0,0,3,3);
+g.fillRect(60,60,63,63);
+r = g.getModifiedRegions();
+results.push(r.length==2);
+results.push(JSON.stringify(g.getModified())=='{"x1":0,"y1":0,"x2":63,"y2":63}');
+
+// drawing close to an existing area merges with it
+g.setPixel(4,4);
+g.drawLine(0,5,5,5);
+r = g.getModifiedRegions();
+results.push(r.length==2);
+results.push(r.some(function(a) { return JSON.stringify(a)=='{"x1":0,"y1":0,"x2":5,"y2":5}'; }));
+
+// drawing inside an existing area doesn't change anything
+g.setPixel(1,1);
+results.push(JSON.stringify(g.getModifiedRegions())==JSON.stringify(r));
+
+// running out of regions merges the closest ones
+g.fillRect(60,0,63,3);
+g.fillRect(0,60,3,63);
+results.push(g.getModifiedRegions().length==4);
+g.fillRect(30,30,31,31);
+r = g.getModifiedRegions(true);
+results.push(r.length==4);
+// every pixel drawn is still inside some region
+results.push([[0,0],[5,5],[63,63],[60,0],[0,63],[30,30],[31,31]].every(function(p) {
+  return r.some(function(a) { return p[0]>=a.x1 && p[0]<=a.x2 && p[1]>=a.y1 && p[1]<=a.y2; });
+}));
+
+// reset clears everything
+results.push(g.getModifiedRegions().length==0);
+results.push(g.getModified()===undefined);
+
+// clipped drawing only marks what was drawn
+g.setClipRect(10,10,20,20);
+g.fillRect(0,0,63,63);
+results.push(JSON.stringify(g.getModifiedRegions(true))=='[{"x1":10,"y1":10,"x2":20,"y2":20}]');
+
+// ArrayBuffers don't flip, so never send anything
+s = g.getFlipStats();
+results.push(s.flips==0 && s.bytes==0);
+
+result = results.every(function(x){return x;});
+if (!result) console.log(results);
@@ -0,0 +1,22 @@
+// Streaming heatshrink Compressor/Decompressor
+var hs = require("heatshrink");
+var txt = "";
+for (var i=0;i<200;i++) txt += "Line "+i+" of some log data\n";
+
+var compressed = "";
+var c = new hs.Compressor();
+c.on('data', function(d) { compressed += d; });
+for (i=0;i<txt.length;i+=50) c.write(txt.substr(i,50));
+c.end();
+
+var decompressed;
+var dst = { s : "", write : function(d) { this.s += d; }, end : function() { decompressed = this.s; } };
+setTimeout(function() {
+  var d = new hs.Decompressor();
+  d.pipe(dst);
+  for (i=0;i<compressed.length;i+=37) d.write(compressed.substr(i,37));
+  d.end();
+  result = compressed == E.toString(hs.compress(txt)) &&
+           compressed.length < txt.length &&
+           decompressed == txt;
+}, 1);
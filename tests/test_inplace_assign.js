@@ -0,0 +1,45 @@
+// ++/-- and compound assignment update numbers in place, but never shared values
+var x = 0.1;
+var y = x;
+x += 1;             // x's value is shared with y, so y must not change
+var s = 0.1;
+for (var i=0;i<10;i++) s += 0.1;
+var a = [1, 2, 0.1];
+a[0] |= 6;
+a[1] <<= 3;
+a[2] *= 2;
+var b = a[2];
+a[2]++;
+var o = { n:5, f:0.3 };
+o.n -= 10;
+o.f *= 2;
+var cnt = 2147483646;
+cnt++; cnt++;       // overflow to float
+var k = 10;
+var k2 = k++ + k--; // 10 + 11
+var big = 2147483647.5;
+big -= 0.5;
+var fs = [];
+for (var j=0;j<3;j++) fs.push(function() { return j; });
+function f(v) { v += 1; return v; }
+var arg = 1.1;
+var fr = f(arg);
+// values inherited from a prototype must be added to the object itself
+function P() {}
+P.prototype.x = 5;
+P.prototype.f = 1.5;
+var p1 = new P(); p1.x += 1;
+var p2 = new P(); p2.x++;
+var p3 = new P(); ++p3.x;
+var p4 = new P(); p4.f *= 2;
+var protoOk = p1.x===6 && JSON.stringify(p1)=='{"x":6}' &&
+              p2.x===6 && JSON.stringify(p2)=='{"x":6}' &&
+              p3.x===6 && JSON.stringify(p3)=='{"x":6}' &&
+              p4.f===3 && JSON.stringify(p4)=='{"f":3}' &&
+              P.prototype.x===5 && P.prototype.f===1.5;
+
+result = protoOk && y===0.1 && x===1.1 && s>1.0999 && s<1.1001 &&
+         a[0]===7 && a[1]===16 && a[2]===1.2 && b===0.2 &&
+         o.n===-5 && o.f===0.6 && cnt===2147483648 &&
+         k===10 && k2===21 && big===2147483647 &&
+         fs[0]()===3 && arg===1.1 && fr===2.1;
@@ -0,0 +1,21 @@
+// Binary operators and ++/-- on plain ints and floats (fast path in the parser)
+var big = 2147483647, small = -2147483648;
+var i = 7, j = -3, f = 2.5, g = 0.5, n = NaN, z = 0;
+var o = { x:5, y:1.5 };
+var a = [10, 2.25];
+var r = [
+  big+1 === 2147483648, small-1 === -2147483649, big*2 === 4294967294,
+  i/2 === 3.5, i%j === 1, j%i === -3, isNaN(i%z), i/z === Infinity,
+  (i&j) === 5, (i|j) === -1, (i^j) === -6, (j>>1) === -2, (j>>>28) === 15, (i<<2) === 28,
+  i<f === false, f<i, f+g === 3, f*g === 1.25, f-i === -4.5, f/g === 5,
+  i==7.0, i===7.0, !(n==n), n!=n, !(n===n), n!==n, !(f<n), !(f>=n),
+  o.x+o.y === 6.5, a[0]*a[1] === 22.5, o.x<=5, o.y>1,
+  1==true, "3"==3, 5+"1"==="51", 2.5%2 === 0.5, (2.5|0) === 2
+];
+var k = 1.5; k++; var k2 = k--;
+var m = big; m++;
+var p = 3; var q = p++ + ++p;
+var refErr = false;
+try { undefinedVariable < 1; } catch (e) { refErr = e instanceof ReferenceError; }
+result = r.every(function(x) { return x; }) &&
+         k===1.5 && k2===2.5 && m===2147483648 && p===5 && q===8 && refErr;
@@ -0,0 +1,19 @@
+// Floats that fit exactly in 32 bits are stored inside the variable's name
+var o = { a:1.5, b:0.1, c:-1234.75, d:1e300, e:NaN, f:-0.5, g:Infinity };
+o.h = 3.125;
+o.a += 1;
+var arr = [0.5, 1.5, 2.1];
+arr[5] = 7.75;
+var x = 0.5;
+x = x/2;
+var y = x;
+y += 1;
+var c = Object.assign({}, o);
+
+result = o.a===2.5 && o.b===0.1 && o.c===-1234.75 && o.d===1e300 &&
+         isNaN(o.e) && o.f===-0.5 && 1/o.f<0 && o.g===Infinity && o.h===3.125 &&
+         arr[0]===0.5 && arr[1]===1.5 && arr[2]===2.1 && arr[5]===7.75 &&
+         arr.indexOf(1.5)==1 && arr.length==6 &&
+         x===0.25 && y===1.25 && typeof x=="number" &&
+         c.a===2.5 && c.h===3.125 && c.b===0.1 &&
+         JSON.stringify({p:0.5,q:[1.25]})=='{"p":0.5,"q":[1.25]}';
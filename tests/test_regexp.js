@@ -79,5 +79,30 @@ test("abcde|f".split(/d|\||b/).join(","), "a,c,e,f");
 test('Some text\nAnd some more\r\nAnd yet\rThis is the end'.split(/\r\n|\r|\n/).join(","),
      "Some text,And some more,And yet,This is the end");
 
+// quantifiers, groups and alternation inside groups
+testreg(/colou?r/.exec("my color"),"color",3);
+testreg(/a+?/.exec("aaa"),"a",0);
+testreg(/(a|b)+c/.exec("xxababc"),"ababc,b",2);
+testreg(/(?:ab)+/.exec("=ababab"),"ababab",1);
+testreg(/(a*)*b/.exec("aaab"),"aaab,aaa",0);
+testreg(/x(y)?z/.exec("xz"),"xz,",0);
+testreg(/\d+,\d+/.exec("abc 12,345 d"),"12,345",4);
+testreg(/c$/.exec("abcabc"),"c",5);
+test(/^abc$/.test("abcd"), false);
+// long strings must not use deep recursion
+var long = "";
+for (var i=0;i<1000;i++) long+="aa";
+test(/a*b/.test(long), false);
+test(/(a+)+$/.test(long), true);
+test(/^(a|b)*$/.exec(long)[0].length, 2000);
+// captures past 64k characters
+while (long.length<70000) long+=long;
+var m = /(b+)(c)?$/.exec(long+"xbbb");
+testreg(m,"bbb,bbb,",long.length+1);
+// long RegExp source
+var src = "x";
+while (src.length<4000) src += "|ab"+src.length;
+testreg(new RegExp("("+src+")z").exec("__ab1234z"),"ab1234z,ab1234",2);
+
 result = tests==testPass;
 console.log(result?"Pass":"Fail",":",tests,"tests total");
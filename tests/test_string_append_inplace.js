@@ -0,0 +1,31 @@
+// Check that 'a = a + b' and 'a += b' (which may append in place) don't modify shared strings
+
+var a = "Hello";
+var b = a;
+a = a + " World";
+var r1 = a=="Hello World" && b=="Hello";
+
+var c = "Hello";
+var d = { x : c };
+c += " World";
+var r2 = c=="Hello World" && d.x=="Hello";
+
+var e = "X";
+for (var i=0;i<200;i++) e = e + "Y";
+var r3 = e.length==201 && e[200]=="Y";
+
+// something else is evaluated after the append
+var f = "A";
+function g() { return f; }
+f = f + "B" + g();
+var r4 = f=="ABA";
+
+var h = "Q";
+h = h + h;
+var r5 = h=="QQ";
+
+var o = { s : "1" };
+o.s = o.s + "2";
+var r6 = o.s=="12";
+
+result = r1 && r2 && r3 && r4 && r5 && r6;
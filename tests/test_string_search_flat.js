@@ -0,0 +1,22 @@
+// indexOf/lastIndexOf/split/replace on flat strings (contiguous fast path)
+var s = "";
+for (var i=0;i<50;i++) s += "0123456789";
+s += "NEEDLE,a,,b";
+var f = E.toString(s);
+
+var r = [
+  f.indexOf("NEEDLE")==500,
+  f.indexOf("0123",1)==10,
+  f.lastIndexOf("0123")==490,
+  f.lastIndexOf("0123",15)==10,
+  f.indexOf("NEEDLES")==-1,
+  f.indexOf("")==0,
+  f.indexOf(s)==0,
+  f.split(",").length==4,
+  f.split(",")[2]=="",
+  f.split("9").length==51,
+  f.replace("NEEDLE","x").length==s.length-5,
+  "a".split("abc").length==1,
+  "aaa".indexOf("aa",1)==1,
+];
+result = r.every(function(x){return x;});
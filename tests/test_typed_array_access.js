@@ -0,0 +1,29 @@
+// Element access must give the same results whether or not the data is contiguous
+function fill(a) {
+  for (var i=0;i<a.length;i++) a[i] = i*37-300;
+  var s = "";
+  for (i=0;i<a.length;i++) s += a[i]+",";
+  a.forEach(function(v) { s += v+","; });
+  return s;
+}
+var str = "";
+for (var i=0;i<160;i++) str += String.fromCharCode(i);
+var results = [];
+[Uint8Array,Int8Array,Uint8ClampedArray,Uint16Array,Int16Array,Uint24Array,Uint32Array,Int32Array,Float32Array,Float64Array].forEach(function(T) {
+  var flat = fill(new T(16));
+  // not flat - a view partway into a normal string
+  var notFlat = fill(new T(E.toArrayBuffer(str), 8, 16));
+  results.push(flat==notFlat);
+});
+// DataView big-endian access on a flat buffer
+var buf = new ArrayBuffer(64);
+var d = new DataView(buf, 2);
+d.setInt16(0, -2);
+d.setFloat32(4, 1.5);
+d.setUint32(8, 0x12345678);
+var u = new Uint8Array(buf, 2, 12);
+
+result = results.indexOf(false)<0 &&
+  d.getInt16(0)==-2 && d.getFloat32(4)==1.5 && d.getUint32(8)==0x12345678 &&
+  d.getInt16(0,true)==-257 &&
+  u[0]==255 && u[1]==254 && u[8]==0x12 && u[11]==0x78;
@@ -0,0 +1,32 @@
+// Typed arrays sort numerically (not as strings) with no compare function
+function isSorted(a) {
+  for (var i=1;i<a.length;i++)
+    if (!(a[i-1]<=a[i]) && !isNaN(a[i])) return false;
+  return true;
+}
+var r = [];
+for (var i=0;i<300;i++) r.push(((i*7919)%1000)-500);
+
+var ok = true;
+[Uint8Array,Int8Array,Uint16Array,Int16Array,Uint24Array,Uint32Array,Int32Array,Float32Array,Float64Array].forEach(function(T) {
+  var a = new T(r);
+  a.sort();
+  ok = ok && isSorted(a);
+  a = new T(200);
+  for (var i=0;i<a.length;i++) a[i] = i; // already sorted
+  a.sort();
+  ok = ok && isSorted(a);
+});
+
+var a = new Uint8Array([10,9,1,2]).sort();
+var b = new Int16Array([-5,100,3,-200]).sort();
+var c = new Float32Array([1.5,NaN,-1,0.25]).sort();
+// a view partway into a buffer only sorts its own elements
+var d = new Uint8Array([9,8,7,6,5,4]);
+new Uint8Array(d.buffer,1,4).sort();
+
+result = ok &&
+  a=="1,2,9,10" &&
+  b=="-200,-5,3,100" &&
+  c=="-1,0.25,1.5,NaN" &&
+  d=="9,5,6,7,8,4";
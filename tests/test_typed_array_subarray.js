@@ -0,0 +1,25 @@
+// subarray gives a view onto the same data. Typed arrays copy normal Strings,
+// but reference Strings in flash and make them read-only
+var a = new Uint8Array([1,2,3,4,5]);
+var b = a.subarray(1,3);
+b[0] = 42;
+var f = new Float32Array([1,2,3,4]);
+var g = f.subarray(2);
+g[1] = 9;
+var s = new Uint8Array("Hello World", 6, 5);
+var str = "Hello";
+var u = new Uint8Array(str);
+u[0] = 74;
+var st = require("Storage");
+st.write("tatest", new Uint8Array([4,3,2,1]));
+var r = new Uint8Array(st.read("tatest"));
+r[0] = 9; r.set([5,5],2); r.fill(7); r.sort();
+var ro = JSON.stringify(r)=="[4,3,2,1]" && st.read("tatest")=="\x04\x03\x02\x01";
+st.erase("tatest");
+
+result = a=="1,42,3,4,5" && b=="42,3" && b.byteOffset==1 &&
+  a.subarray(-2)=="4,5" && a.subarray(3,1).length==0 &&
+  a.subarray()=="1,42,3,4,5" && a.subarray(1,-1)=="42,3,4" &&
+  f=="1,2,3,9" && g.byteOffset==8 && g.subarray(1)=="9" &&
+  E.getAddressOf(b.buffer)==E.getAddressOf(a.buffer) &&
+  s=="87,111,114,108,100" && str=="Hello" && u[0]==74 && ro;
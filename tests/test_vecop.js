@@ -0,0 +1,45 @@
+// E.vecOp element-wise operations on typed arrays
+var a = new Int16Array([1000,-2000,30000]);
+E.vecOp(a, a, 2, "mul"); // saturates rather than wrapping
+var r1 = a.toString();
+E.vecOp(a, a, new Int16Array([1,2,3]), "add");
+var r2 = a.toString();
+E.vecOp(a, a, [-3000,3000], "clip");
+var r3 = a.toString();
+
+var f = new Float32Array([1.5,-2.25,3,-0.5]);
+var u = new Uint8Array(4);
+E.vecOp(u, f, 100, "mul");
+var g = new Float32Array(4);
+E.vecOp(g, f, undefined, "abs");
+var m = new Float32Array(4);
+E.vecOp(m, g, new Uint8Array([2,2]), "min"); // only as long as the shortest
+var s = new Int8Array([10,20,30]);
+E.vecOp(s, s, new Float64Array([0.5,100,-200]), "sub");
+var big = new Uint32Array([4000000000]);
+E.vecOp(big, big, 1, "add");
+// scalars too big for integer maths must still saturate correctly
+var i32 = new Int32Array([1e6,-1e6]);
+E.vecOp(i32, i32, 1e13, "mul");
+var i32b = new Int32Array([5,-5]);
+E.vecOp(i32b, i32b, 1e19, "add");
+var i32c = new Int32Array([5,-5]);
+E.vecOp(i32c, i32c, -Infinity, "add");
+
+var err = 0;
+try { E.vecOp(f, f, 1, "foo"); } catch (e) { err++; }
+try { E.vecOp(f, f, "x", "add"); } catch (e) { err++; }
+try { E.vecOp(f, f, 1, "clip"); } catch (e) { err++; }
+
+result = r1=="2000,-4000,32767" &&
+  r2=="2001,-3998,32767" &&
+  r3=="2001,-3000,3000" &&
+  u=="150,0,255,0" &&
+  g=="1.5,2.25,3,0.5" &&
+  m=="1.5,2,0,0" &&
+  s=="9,-80,127" &&
+  big[0]==4000000001 &&
+  i32=="2147483647,-2147483648" &&
+  i32b=="2147483647,2147483647" &&
+  i32c=="-2147483648,-2147483648" &&
+  err==3;